@@ -0,0 +1,360 @@
+/*
+ * bench.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <8bee.h>
+#include "../Source/transform.h"
+#include "../Source/window.h"
+#include "../Source/video.h"
+#include "../Source/res.h"
+#include "../Source/clock.h"
+#include "../Source/option.h"
+#include "../Source/audio.h"
+#include "../Source/clip.h"
+#include "../Source/chunk.h"
+#include <mint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "../Source/editor/res/editor.h"
+
+typedef void (*bench_t)(void* data, int count);
+
+static long long g_time = 250000000;
+static const char* g_filter;
+static uint32_t g_random = 0x8BEE;
+
+static uint32_t bench_random() {
+	g_random ^= g_random << 13;
+	g_random ^= g_random >> 17;
+	g_random ^= g_random << 5;
+	return g_random;
+}
+
+// runs the benchmark with growing counts until it takes long enough to measure
+static void bench_run(const char* name, const char* unit, double scale, bench_t bench, void* data) {
+	if (g_filter != NULL && strstr(name, g_filter) == NULL) {
+		return;
+	}
+
+	int count = 1;
+	long long time;
+	for (;;) {
+		long long begin = bee__clock_get();
+		bench(data, count);
+		time = bee__clock_get() - begin;
+		if (time >= g_time || count >= 0x40000000) {
+			break;
+		}
+		count *= time < g_time / 16 ? 16 : 2;
+	}
+
+	double seconds = time / 1e9;
+	printf("{\"name\":\"%s\",\"iterations\":%i,\"seconds\":%.6f,\"unit\":\"%s\",\"value\":%.3f}\n",
+			name, count, seconds, unit, count * scale / seconds);
+	fflush(stdout);
+}
+
+// sprites
+
+#define SPRITES_FRAME 1024
+
+// wrapped so it can be passed as benchmark data, function pointers do not convert to void*
+typedef struct transform_t {
+	void (*apply)(int index);
+} transform_t;
+
+static void transform_identity(int index) {
+}
+
+static void transform_translate(int index) {
+	bee_translate(index % 97 - 48, index % 89 - 44);
+}
+
+static void transform_scale(int index) {
+	bee_translate(index % 97 - 48, index % 89 - 44);
+	bee_scale(index % 3 + 1, index % 2 + 1);
+}
+
+static void transform_rotate(int index) {
+	bee_translate(index % 97 - 48, index % 89 - 44);
+	bee_rotate(index * 7 % 360);
+}
+
+static transform_t g_identity = {transform_identity};
+static transform_t g_translate = {transform_translate};
+static transform_t g_scale = {transform_scale};
+static transform_t g_rotate = {transform_rotate};
+
+static const bee_sprite_t g_sprites[] = {
+		{8, 0, 8, 8},
+		{0, 94, 34, 34},
+		{64, 8, 32, 32},
+		{32, 8, 8, 8}
+};
+
+static void bench_sprites(void* data, int count) {
+	const transform_t* transform = data;
+	for (int frame = 0; frame < count; ++frame) {
+		for (int i = 0; i < SPRITES_FRAME; ++i) {
+			bee_push();
+			// moving the first sprite every frame stops frames being skipped as unchanged
+			if (i == 0) {
+				bee_translate(frame & 1, 0);
+			}
+			transform->apply(i);
+			bee_draw(g_sprites + i % 4);
+			bee_pop();
+		}
+		bee__video_update();
+	}
+}
+
+static void bench_static(void* data, int count) {
+	for (int frame = 0; frame < count; ++frame) {
+		for (int i = 0; i < SPRITES_FRAME; ++i) {
+			bee_push();
+			transform_translate(i);
+			bee_draw(g_sprites + i % 4);
+			bee_pop();
+		}
+		bee__video_update();
+	}
+}
+
+// an empty frame is skipped as unchanged so only the present is left
+static void bench_present(void* data, int count) {
+	for (int frame = 0; frame < count; ++frame) {
+		bee__video_update();
+	}
+}
+
+// resources
+
+typedef struct payload_t {
+	int length;
+	unsigned char* data;
+} payload_t;
+
+// encodes pixels the same way as Script/prebuild.c
+static payload_t payload_encode(const uint16_t* pixels, _Bool lz) {
+	payload_t payload = {0, malloc(5 + BEE__CHUNK_MAX + 1)};
+	payload.data[0] = 0x22;
+	payload.data[1] = 0x01;
+	payload.data[2] = 0x04;
+	payload.data[3] = 0x80;
+	payload.data[4] = BEE__CHUNK_VIDEO | (lz ? BEE__CHUNK_LZ : 0);
+	payload.length = 5 + bee__chunk_encode(pixels, lz, payload.data + 5);
+	payload.data[payload.length++] = BEE__CHUNK_END;
+	return payload;
+}
+
+static void payload_solid(uint16_t* pixels) {
+	for (int i = 0; i < 128 * 128; ++i) {
+		pixels[i] = 0x5AFF;
+	}
+}
+
+static void payload_noisy(uint16_t* pixels) {
+	for (int i = 0; i < 128 * 128; ++i) {
+		pixels[i] = (bench_random() << 4) | 0xF;
+	}
+}
+
+static void payload_runs(uint16_t* pixels) {
+	for (int i = 0; i < 128 * 128;) {
+		uint16_t color = (bench_random() << 4) | 0xF;
+		int count = bench_random() % 450 + 50;
+		for (; count > 0 && i < 128 * 128; --count) {
+			pixels[i++] = color;
+		}
+	}
+}
+
+// two colour checkerboards in random rectangles, like shading in hand drawn art
+static void payload_dither(uint16_t* pixels) {
+	memset(pixels, 0, 128 * 128 * sizeof(uint16_t));
+	for (int i = 0; i < 48; ++i) {
+		int x0 = bench_random() % 112;
+		int y0 = bench_random() % 112;
+		int x1 = x0 + bench_random() % 16 + 16;
+		int y1 = y0 + bench_random() % 16 + 16;
+		uint16_t a = (bench_random() << 4) | 0xF;
+		uint16_t b = (bench_random() << 4) | 0xF;
+		for (int y = y0; y < y1 && y < 128; ++y) {
+			for (int x = x0; x < x1 && x < 128; ++x) {
+				pixels[y * 128 + x] = (x + y) & 1 ? a : b;
+			}
+		}
+	}
+}
+
+// a few detailed 16x16 tiles repeated over the sheet, like animation frames or tilesets
+static void payload_tiles(uint16_t* pixels) {
+	static uint16_t tiles[4][16 * 16];
+	for (int i = 0; i < 4 * 16 * 16; ++i) {
+		tiles[i / 256][i % 256] = bench_random() % 3 == 0 ? 0 : (bench_random() << 4) | 0xF;
+	}
+	for (int ty = 0; ty < 8; ++ty) {
+		for (int tx = 0; tx < 8; ++tx) {
+			const uint16_t* tile = tiles[bench_random() % 4];
+			for (int y = 0; y < 16; ++y) {
+				memcpy(pixels + (ty * 16 + y) * 128 + tx * 16, tile + y * 16, 16 * sizeof(uint16_t));
+			}
+		}
+	}
+}
+
+static void bench_decode(void* data, int count) {
+	payload_t* payload = data;
+	for (int i = 0; i < count; ++i) {
+		bee__res_data(payload->length, payload->data, 0);
+	}
+}
+
+// prints the encoded size of both encodings and times decoding each of them
+static void bench_payload(const char* name, void (*generate)(uint16_t* pixels)) {
+	static uint16_t pixels[128 * 128];
+	generate(pixels);
+	for (int lz = 0; lz < 2; ++lz) {
+		payload_t payload = payload_encode(pixels, lz);
+		char label[64];
+		snprintf(label, sizeof(label), lz ? "size/%s/lz" : "size/%s", name);
+		if (g_filter == NULL || strstr(label, g_filter) != NULL) {
+			printf("{\"name\":\"%s\",\"unit\":\"bytes\",\"value\":%i}\n", label, payload.length);
+		}
+		snprintf(label, sizeof(label), lz ? "decode/%s/lz" : "decode/%s", name);
+		bench_run(label, "chunks/s", 1, bench_decode, &payload);
+		free(payload.data);
+	}
+}
+
+// transforms
+
+static void bench_push_pop(void* data, int count) {
+	for (int i = 0; i < count; ++i) {
+		bee_push();
+		bee_pop();
+	}
+}
+
+static void bench_translate(void* data, int count) {
+	bee_push();
+	for (int i = 0; i < count; ++i) {
+		bee_translate(i & 1, -(i & 1));
+	}
+	bee_pop();
+}
+
+static void bench_scale(void* data, int count) {
+	bee_push();
+	for (int i = 0; i < count; ++i) {
+		bee_identity();
+		bee_scale(2, 3);
+	}
+	bee_pop();
+}
+
+static void bench_rotate(void* data, int count) {
+	bee_push();
+	for (int i = 0; i < count; ++i) {
+		bee_rotate(i % 360);
+	}
+	bee_pop();
+}
+
+// clips
+
+#define CLIP_LENGTH BEE__AUDIO_RATE
+#define CLIP_BLOCK 256
+
+static int g_clip_samples[CLIP_LENGTH];
+static int8_t g_clip_pcm8[CLIP_LENGTH];
+static unsigned char g_clip_adpcm4[CLIP_LENGTH / 2];
+
+static const bee_note_t g_clip_notes[] = {
+		{262, CLIP_LENGTH / 4}, {330, CLIP_LENGTH / 4}, {0, CLIP_LENGTH / 4}, {392, CLIP_LENGTH / 4}
+};
+static const bee_synth_t g_clip_synth = {BEE_WAVE_TRIANGLE, 8000, 441, 441, g_clip_notes, 4};
+
+static void clip_init() {
+	for (int i = 0; i < CLIP_LENGTH; ++i) {
+		g_clip_samples[i] = sin(i * 440 * 6.283185307 / BEE__AUDIO_RATE) * 8000 + (int)(bench_random() % 512) - 256;
+		g_clip_pcm8[i] = g_clip_samples[i] / 256;
+	}
+	bee__clip_encode(g_clip_samples, CLIP_LENGTH, g_clip_adpcm4);
+}
+
+static void bench_clip(void* data, int count) {
+	static int buffer[CLIP_BLOCK];
+	for (int i = 0; i < count; ++i) {
+		bee__clip_state_t state = {0};
+		while (bee__clip_mix(&state, data, buffer, CLIP_BLOCK) > 0);
+	}
+}
+
+int main(int argc, char* argv[]) {
+	bee__option_init(argc, argv);
+	mint_init("bench.log");
+
+	const char* time = bee__option_get("time");
+	if (time != NULL) {
+		g_time = atoll(time) * 1000000;
+	}
+	g_filter = bee__option_get("filter");
+
+	bee__transform_init();
+	bee__window_init();
+	bee__video_init();
+	bee__option_check();
+
+	// sprites draw from the editor sheet on page 0
+	bee__res_data(sizeof(bee__editor_res_editor), bee__editor_res_editor, 0);
+	bench_run("sprites/identity", "sprites/s", SPRITES_FRAME, bench_sprites, &g_identity);
+	bench_run("sprites/translate", "sprites/s", SPRITES_FRAME, bench_sprites, &g_translate);
+	bench_run("sprites/scale", "sprites/s", SPRITES_FRAME, bench_sprites, &g_scale);
+	bench_run("sprites/rotate", "sprites/s", SPRITES_FRAME, bench_sprites, &g_rotate);
+	bench_run("sprites/static", "sprites/s", SPRITES_FRAME, bench_static, NULL);
+	bench_run("video/present", "frames/s", 1, bench_present, NULL);
+
+	payload_t sheet = {sizeof(bee__editor_res_editor), (unsigned char*)bee__editor_res_editor};
+	bench_run("decode/sheet", "chunks/s", 1, bench_decode, &sheet);
+	bench_payload("solid", payload_solid);
+	bench_payload("noisy", payload_noisy);
+	bench_payload("runs", payload_runs);
+	bench_payload("dither", payload_dither);
+	bench_payload("tiles", payload_tiles);
+
+	bench_run("transform/push_pop", "ops/s", 1, bench_push_pop, NULL);
+	bench_run("transform/translate", "ops/s", 1, bench_translate, NULL);
+	bench_run("transform/scale", "ops/s", 2, bench_scale, NULL);
+	bench_run("transform/rotate", "ops/s", 1, bench_rotate, NULL);
+
+	clip_init();
+	bee_clip_t clip_int = {g_clip_samples, CLIP_LENGTH, BEE_FORMAT_INT};
+	bee_clip_t clip_pcm8 = {NULL, CLIP_LENGTH, BEE_FORMAT_PCM8, g_clip_pcm8};
+	bee_clip_t clip_adpcm4 = {NULL, CLIP_LENGTH, BEE_FORMAT_ADPCM4, g_clip_adpcm4};
+	bee_clip_t clip_synth = {NULL, CLIP_LENGTH, BEE_FORMAT_SYNTH, &g_clip_synth};
+	bench_run("clip/int", "samples/s", CLIP_LENGTH, bench_clip, &clip_int);
+	bench_run("clip/pcm8", "samples/s", CLIP_LENGTH, bench_clip, &clip_pcm8);
+	bench_run("clip/adpcm4", "samples/s", CLIP_LENGTH, bench_clip, &clip_adpcm4);
+	bench_run("clip/synth", "samples/s", CLIP_LENGTH, bench_clip, &clip_synth);
+	return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * replay.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <8bee.h>
+#include "../Source/window.h"
+#include "../Source/video.h"
+#include "../Source/trace.h"
+#include "../Source/file.h"
+#include "../Source/clock.h"
+#include "../Source/option.h"
+#include <mint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct reader_t {
+	const unsigned char* data;
+	int length;
+	int index;
+} reader_t;
+
+static void** g_textures;
+static int g_texture_count = 0;
+static unsigned short* g_pixels;
+static unsigned char* g_indices;
+static unsigned short g_colors[256];
+
+static int reader_u8(reader_t* reader) {
+	if (reader->index + 1 > reader->length) {
+		mint_fail("REPLAY: Unexpected end of trace");
+	}
+	return reader->data[reader->index++];
+}
+
+static int reader_u16(reader_t* reader) {
+	int value = reader_u8(reader);
+	return value | (reader_u8(reader) << 8);
+}
+
+static int reader_i32(reader_t* reader) {
+	unsigned int value = reader_u16(reader);
+	return value | ((unsigned int)reader_u16(reader) << 16);
+}
+
+static void* reader_texture(reader_t* reader) {
+	int id = reader_u16(reader);
+	if (id == BEE__TRACE_SCREEN) {
+		return NULL;
+	}
+	if (id >= g_texture_count) {
+		mint_fail("REPLAY: Invalid texture %i", id);
+	}
+	return g_textures[id];
+}
+
+static void reader_sprite(reader_t* reader, bee_sprite_t* sprite) {
+	sprite->x = reader_u16(reader);
+	sprite->y = reader_u16(reader);
+	sprite->w = reader_u16(reader);
+	sprite->h = reader_u16(reader);
+	sprite->page = 0;
+}
+
+// plays the whole trace once, textures are only created the first time through
+static void replay_run(const bee__file_t* file, int* frames, int* draws) {
+	reader_t reader = {file->data, file->length, 4};
+	int created = 0;
+	while (reader.index < reader.length) {
+		bee_sprite_t sprite;
+		bee__matrix_t matrix;
+		void* texture;
+		switch (reader_u8(&reader)) {
+		case BEE__TRACE_CREATE:
+		case BEE__TRACE_CREATE_INDEXED: {
+			_Bool indexed = reader.data[reader.index - 1] == BEE__TRACE_CREATE_INDEXED;
+			int width = reader_u16(&reader);
+			int height = reader_u16(&reader);
+			if (created++ == g_texture_count) {
+				mint_array_check(g_textures, g_texture_count + 1);
+				if (indexed) {
+					g_textures[g_texture_count++] = bee__video_index_create_native(width, height);
+				} else {
+					g_textures[g_texture_count++] = bee__video_texture_create_native(width, height, NULL);
+				}
+			}
+			break;
+		}
+		case BEE__TRACE_UPDATE:
+			texture = reader_texture(&reader);
+			reader_sprite(&reader, &sprite);
+			mint_array_check(g_pixels, sprite.w * sprite.h);
+			for (int i = 0; i < sprite.w * sprite.h; ++i) {
+				g_pixels[i] = reader_u16(&reader);
+			}
+			bee__video_texture_update_native(texture, &sprite, g_pixels);
+			break;
+		case BEE__TRACE_UPDATE_INDEXED:
+			texture = reader_texture(&reader);
+			reader_sprite(&reader, &sprite);
+			mint_array_check(g_indices, sprite.w * sprite.h);
+			for (int i = 0; i < sprite.w * sprite.h; ++i) {
+				g_indices[i] = reader_u8(&reader);
+			}
+			bee__video_index_update_native(texture, &sprite, g_indices);
+			break;
+		case BEE__TRACE_PALETTE: {
+			int index = reader_u16(&reader);
+			int count = reader_u16(&reader);
+			if (index + count > 256) {
+				mint_fail("REPLAY: Invalid palette");
+			}
+			for (int i = 0; i < count; ++i) {
+				g_colors[i] = reader_u16(&reader);
+			}
+			bee__video_palette_native(index, count, g_colors);
+			break;
+		}
+		case BEE__TRACE_TARGET:
+			bee__video_texture_target_native(reader_texture(&reader));
+			break;
+		case BEE__TRACE_CLEAR:
+			bee__video_clear_native();
+			break;
+		case BEE__TRACE_DRAW:
+		case BEE__TRACE_DRAW_ALIGNED: {
+			_Bool aligned = reader.data[reader.index - 1] == BEE__TRACE_DRAW_ALIGNED;
+			texture = reader_texture(&reader);
+			reader_sprite(&reader, &sprite);
+			matrix.m00 = reader_i32(&reader);
+			matrix.m01 = aligned ? 0 : reader_i32(&reader);
+			matrix.m02 = reader_i32(&reader);
+			matrix.m10 = aligned ? 0 : reader_i32(&reader);
+			matrix.m11 = reader_i32(&reader);
+			matrix.m12 = reader_i32(&reader);
+			bee__video_texture_draw_native(texture, &sprite, &matrix);
+			++*draws;
+			break;
+		}
+		case BEE__TRACE_PRESENT:
+			texture = reader_texture(&reader);
+			if (texture == NULL) {
+				mint_fail("REPLAY: Invalid texture");
+			}
+			bee__video_present_native(texture);
+			++*frames;
+			break;
+		default:
+			mint_fail("REPLAY: Invalid command %i", reader.data[reader.index - 1]);
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	bee__option_init(argc, argv);
+	mint_init("replay.log");
+
+	const char* path = bee__option_get("trace");
+	if (path == NULL) {
+		mint_fail("REPLAY: No trace given, use trace=path");
+	}
+	int loops = 1;
+	const char* option = bee__option_get("loops");
+	if (option != NULL) {
+		loops = atoi(option);
+	}
+
+	bee__window_init();
+	bee__video_init_native(bee__window_get());
+	bee__option_check();
+
+	bee__file_t* file = bee__file_map(path);
+	if (file == NULL) {
+		mint_fail("REPLAY: Failed to open '%s'", path);
+	}
+	if (file->length < 4 || memcmp(file->data, BEE__TRACE_MAGIC, 4) != 0) {
+		mint_fail("REPLAY: Invalid trace");
+	}
+
+	// the first pass also uploads the textures so it is not timed
+	int frames = 0;
+	int draws = 0;
+	replay_run(file, &frames, &draws);
+
+	frames = 0;
+	draws = 0;
+	long long begin = bee__clock_get();
+	for (int i = 0; i < loops; ++i) {
+		replay_run(file, &frames, &draws);
+	}
+	double seconds = (bee__clock_get() - begin) / 1e9;
+	printf("{\"name\":\"replay\",\"frames\":%i,\"draws\":%i,\"seconds\":%.6f,\"fps\":%.3f,\"draws_per_second\":%.3f}\n",
+			frames, draws, seconds, frames / seconds, draws / seconds);
+	return 0;
+}
@@ -23,6 +23,19 @@
 extern "C" {
 #endif
 
+// buttons in the bee_input bitmask
+#define BEE_INPUT_UP 0x01
+#define BEE_INPUT_DOWN 0x02
+#define BEE_INPUT_LEFT 0x04
+#define BEE_INPUT_RIGHT 0x08
+#define BEE_INPUT_A 0x10
+#define BEE_INPUT_B 0x20
+#define BEE_INPUT_START 0x40
+#define BEE_INPUT_SELECT 0x80
+
+// palette entries that resource colours index into and bee_palette can replace
+#define BEE_PALETTE_SIZE 64
+
 typedef void (*bee_callback_t)(void* data);
 
 typedef struct bee_sprite_t {
@@ -30,19 +43,106 @@ typedef struct bee_sprite_t {
 	int y;
 	int w;
 	int h;
+	int page;
 } bee_sprite_t;
 
+typedef enum bee_format_t {
+	// samples are ints in the signed 16-bit range
+	BEE_FORMAT_INT,
+	// data is signed 8-bit samples
+	BEE_FORMAT_PCM8,
+	// data is 4-bit IMA ADPCM, two samples per byte with the low nibble first
+	BEE_FORMAT_ADPCM4,
+	// data is a bee_synth_t rendered while mixing
+	BEE_FORMAT_SYNTH
+} bee_format_t;
+
+typedef enum bee_wave_t {
+	BEE_WAVE_SQUARE,
+	BEE_WAVE_PULSE,
+	BEE_WAVE_TRIANGLE,
+	BEE_WAVE_SAW,
+	BEE_WAVE_NOISE
+} bee_wave_t;
+
+typedef struct bee_note_t {
+	// hertz, zero for a rest
+	int frequency;
+	// samples
+	int length;
+} bee_note_t;
+
+typedef struct bee_synth_t {
+	bee_wave_t wave;
+	// peak amplitude in the signed 16-bit range
+	int volume;
+	// samples to fade in and out at the start and end of every note
+	int attack;
+	int release;
+	const bee_note_t* notes;
+	int count;
+} bee_synth_t;
+
 typedef struct bee_clip_t {
+	// mono samples at 44100 Hz
 	int* samples;
+	// samples to play, for synths this should be the sum of the note lengths
 	int length;
+	bee_format_t format;
+	const void* data;
 } bee_clip_t;
 
+typedef struct bee_frame_t {
+	// frames started since launch
+	unsigned int count;
+	// microseconds between the start of this frame and the last
+	int delta;
+	// microseconds the last frame spent updating and drawing
+	int work;
+} bee_frame_t;
+
+typedef struct bee_profile_t {
+	// microseconds spent in each phase, nested phases are included in their parents
+	int window;
+	int scene;
+	int video;
+	int flush;
+	int bind;
+	int target;
+
+	int sprites;
+	int flushes;
+	int draws;
+	int binds;
+	int targets;
+	// frames whose sprites matched the last frame and were not redrawn
+	int skips;
+	// graphics calls dropped because the state was already set, not counting the batch state a flush puts back
+	int redundant;
+	// bytes of frame memory handed out before the end of the frame took it back
+	int arena;
+} bee_profile_t;
+
+typedef struct bee_save_t {
+	// calls to bee_savedata since launch
+	unsigned int requested;
+	// the latest call that is safely on disk, calls in between may have been merged into it
+	unsigned int written;
+	// nonzero if the last write failed, it is tried again on the next call
+	int failed;
+} bee_save_t;
+
 void bee_main(void* data);
 void bee_scene(bee_callback_t scene, void* data);
 unsigned char bee_input();
 void bee_draw(const bee_sprite_t* sprite);
+// colours are RGBA4444, pages that needed more than the palette can hold keep their own colours
+void bee_palette(int index, int count, const unsigned short* colors);
 void bee_play(const bee_clip_t* clip, bee_callback_t end);
 void bee_savedata(void* data, int length);
+const bee_frame_t* bee_frame();
+int bee_profile(bee_profile_t* frames, int count);
+const bee_save_t* bee_save();
 
 void bee_push();
 void bee_pop();
@@ -0,0 +1,453 @@
+/*
+ * prebuild.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <8bee.h>
+#include "../Source/file.h"
+#include "../Source/thread.h"
+#include "../Source/option.h"
+#include "../Source/chunk.h"
+#include <mint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// changing how anything is converted should bump this so every output is rebuilt
+#define PREBUILD_VERSION 1
+
+#define PREBUILD_WORKERS 16
+
+#define PREBUILD_STREAM 0x22010480
+#define PREBUILD_INDEXED 0x22010481
+
+typedef enum job_type_t {
+	JOB_GLSL,
+	JOB_DDS
+} job_type_t;
+
+typedef struct buffer_t {
+	unsigned char* data;
+	int length;
+	int capacity;
+} buffer_t;
+
+typedef struct job_t {
+	job_type_t type;
+	const char* input;
+	const char* var;
+	char* output;
+	const bee__file_t* file;
+	uint64_t hash;
+	// headers are only written when stale, sheets are still encoded if the pack needs them
+	_Bool write;
+	_Bool encode;
+	buffer_t chunk;
+} job_t;
+
+typedef struct entry_t {
+	uint64_t hash;
+	char* path;
+} entry_t;
+
+// the engine's own resources, paths are relative to this directory
+static const char* g_defaults[] = {
+		"../Source/gles/res/shader_main_vert.glsl", "bee__res_shader_main_vert",
+		"../Source/gles/res/shader_main_frag.glsl", "bee__res_shader_main_frag",
+		"../Source/gles/res/shader_blit_vert.glsl", "bee__res_shader_blit_vert",
+		"../Source/gles/res/shader_index_frag.glsl", "bee__res_shader_index_frag",
+		"../Source/editor/res/editor.dds", "bee__editor_res_editor"
+};
+
+static job_t* g_jobs;
+static int g_job_count = 0;
+static entry_t* g_cache;
+static int g_cache_count = 0;
+static atomic_int g_job_next;
+static uint8_t g_video = BEE__CHUNK_VIDEO;
+
+static void buffer_reserve(buffer_t* buffer, int length) {
+	if (buffer->length + length > buffer->capacity) {
+		buffer->capacity = (buffer->length + length) * 2;
+		buffer->data = realloc(buffer->data, buffer->capacity);
+		if (buffer->data == NULL) {
+			mint_fail("PREBUILD: Out of memory");
+		}
+	}
+}
+
+static void buffer_u8(buffer_t* buffer, int value) {
+	buffer_reserve(buffer, 1);
+	buffer->data[buffer->length++] = value;
+}
+
+static void buffer_u32(buffer_t* buffer, uint32_t value) {
+	buffer_u8(buffer, value >> 24);
+	buffer_u8(buffer, (value >> 16) & 0xFF);
+	buffer_u8(buffer, (value >> 8) & 0xFF);
+	buffer_u8(buffer, value & 0xFF);
+}
+
+static void buffer_write(buffer_t* buffer, const void* data, int length) {
+	buffer_reserve(buffer, length);
+	memcpy(buffer->data + buffer->length, data, length);
+	buffer->length += length;
+}
+
+static void buffer_text(buffer_t* buffer, const char* text) {
+	buffer_write(buffer, text, strlen(text));
+}
+
+static void buffer_free(buffer_t* buffer) {
+	free(buffer->data);
+	buffer->data = NULL;
+	buffer->length = 0;
+	buffer->capacity = 0;
+}
+
+static uint64_t prebuild_hash(uint64_t hash, const void* data, int length) {
+	const unsigned char* bytes = data;
+	for (int i = 0; i < length; ++i) {
+		hash = (hash ^ bytes[i]) * 0x100000001B3;
+	}
+	return hash;
+}
+
+static _Bool prebuild_exists(const char* path) {
+	FILE* file = fopen(path, "rb");
+	if (file == NULL) {
+		return 0;
+	}
+	fclose(file);
+	return 1;
+}
+
+static void prebuild_replace(const char* path, const buffer_t* buffer) {
+	if (!bee__file_replace(path, buffer->data, buffer->length)) {
+		mint_fail("PREBUILD: Failed to write '%s'", path);
+	}
+}
+
+// writes the bytes as a C array the way the engine includes its resources
+static void prebuild_c(const char* type, const char* var, const buffer_t* bytes, buffer_t* out) {
+	buffer_text(out, "static const ");
+	buffer_text(out, type);
+	buffer_text(out, " ");
+	buffer_text(out, var);
+	buffer_text(out, "[]={");
+	for (int i = 0; i < bytes->length; ++i) {
+		char number[8];
+		int length = snprintf(number, sizeof(number), i == 0 ? "%i" : ",%i", bytes->data[i]);
+		buffer_write(out, number, length);
+	}
+	buffer_text(out, "};");
+}
+
+// reads a 128x128 ARGB4444 DDS into RGBA4444 rows from the top,
+// sheets have always been converted fully opaque so the alpha channel is ignored
+static void dds_decode(const job_t* job, uint16_t* image) {
+	const unsigned char* data = job->file->data;
+	int length = job->file->length;
+	if (length < 8 || memcmp(data, "DDS ", 4) != 0) {
+		mint_fail("PREBUILD: Invalid DDS '%s'", job->input);
+	}
+	int offset = 4 + (data[4] | (data[5] << 8) | (data[6] << 16) | (data[7] << 24));
+	if (offset < 8 || length - offset < BEE__CHUNK_PIXELS * 2) {
+		mint_fail("PREBUILD: Invalid DDS '%s'", job->input);
+	}
+
+	data += offset;
+	for (int y = 127; y >= 0; --y) {
+		for (int x = 0; x < 128; ++x, data += 2) {
+			uint16_t pixel = data[0] | (data[1] << 8);
+			image[y * 128 + x] = ((pixel << 4) & 0xFFF0) | 0xF;
+		}
+	}
+}
+
+static void job_run(job_t* job) {
+	buffer_t bytes = {0};
+	buffer_t out = {0};
+	if (job->type == JOB_GLSL) {
+		buffer_write(&bytes, job->file->data, job->file->length);
+		buffer_u8(&bytes, 0);
+		prebuild_c("char", job->var, &bytes, &out);
+	} else {
+		uint16_t image[BEE__CHUNK_PIXELS];
+		dds_decode(job, image);
+		buffer_reserve(&job->chunk, BEE__CHUNK_MAX);
+		job->chunk.length = bee__chunk_encode(image, g_video & BEE__CHUNK_LZ, job->chunk.data);
+		if (job->write) {
+			buffer_u32(&bytes, PREBUILD_STREAM);
+			buffer_u8(&bytes, g_video);
+			buffer_write(&bytes, job->chunk.data, job->chunk.length);
+			buffer_u8(&bytes, BEE__CHUNK_END);
+			prebuild_c("unsigned char", job->var, &bytes, &out);
+		}
+	}
+
+	if (job->write) {
+		prebuild_replace(job->output, &out);
+		mint_info("PREBUILD: '%s' -> '%s'", job->input, job->output);
+	}
+	buffer_free(&bytes);
+	buffer_free(&out);
+}
+
+static void worker_main(void* data) {
+	for (;;) {
+		int index = atomic_fetch_add(&g_job_next, 1);
+		if (index >= g_job_count) {
+			break;
+		}
+		if (g_jobs[index].encode) {
+			job_run(g_jobs + index);
+		}
+	}
+}
+
+static void job_add(const char* input, const char* var) {
+	mint_array_check(g_jobs, g_job_count + 1);
+	job_t* job = g_jobs + g_job_count++;
+	memset(job, 0, sizeof(job_t));
+	job->input = input;
+	job->var = var;
+
+	const char* ext = strrchr(input, '.');
+	if (ext != NULL && strcmp(ext, ".glsl") == 0) {
+		job->type = JOB_GLSL;
+	} else if (ext != NULL && strcmp(ext, ".dds") == 0) {
+		job->type = JOB_DDS;
+	} else {
+		mint_fail("PREBUILD: Unknown file type '%s'", input);
+	}
+
+	// the output sits next to the input with a .h extension
+	int stem = ext - input;
+	job->output = malloc(stem + 3);
+	memcpy(job->output, input, stem);
+	strcpy(job->output + stem, ".h");
+}
+
+// lists are lines of an input path and a variable name, blank lines and lines starting with # are skipped
+static void job_list(const char* path) {
+	bee__file_t* file = bee__file_map(path);
+	if (file == NULL) {
+		mint_fail("PREBUILD: Failed to open '%s'", path);
+	}
+
+	char* text = malloc(file->length + 1);
+	memcpy(text, file->data, file->length);
+	text[file->length] = '\0';
+	mint_destroy(file);
+	for (char* line = strtok(text, "\r\n"); line != NULL; line = strtok(NULL, "\r\n")) {
+		char* input = line + strspn(line, " \t");
+		if (*input == '\0' || *input == '#') {
+			continue;
+		}
+		char* var = input + strcspn(input, " \t");
+		if (*var != '\0') {
+			*var++ = '\0';
+			var += strspn(var, " \t");
+			var[strcspn(var, " \t")] = '\0';
+		}
+		if (*var == '\0') {
+			mint_fail("PREBUILD: Missing variable for '%s' in '%s'", input, path);
+		}
+		job_add(input, var);
+	}
+}
+
+// the cache holds a line for every output of the hash of what it was built from
+static void cache_load(const char* path) {
+	bee__file_t* file = bee__file_map(path);
+	if (file == NULL) {
+		return;
+	}
+
+	// unmapped once copied since the cache is replaced at the end, which windows refuses while mapped
+	char* text = malloc(file->length + 1);
+	memcpy(text, file->data, file->length);
+	text[file->length] = '\0';
+	mint_destroy(file);
+	for (char* line = strtok(text, "\r\n"); line != NULL; line = strtok(NULL, "\r\n")) {
+		unsigned long long hash;
+		int length;
+		if (sscanf(line, "%16llx %n", &hash, &length) == 1 && line[length] != '\0') {
+			mint_array_check(g_cache, g_cache_count + 1);
+			g_cache[g_cache_count].hash = hash;
+			g_cache[g_cache_count].path = line + length;
+			++g_cache_count;
+		}
+	}
+}
+
+static _Bool cache_fresh(const char* path, uint64_t hash) {
+	for (int i = 0; i < g_cache_count; ++i) {
+		if (g_cache[i].hash == hash && strcmp(g_cache[i].path, path) == 0) {
+			return prebuild_exists(path);
+		}
+	}
+	return 0;
+}
+
+static void cache_line(buffer_t* out, const char* path, uint64_t hash) {
+	char number[20];
+	snprintf(number, sizeof(number), "%016llx ", (unsigned long long)hash);
+	buffer_text(out, number);
+	buffer_text(out, path);
+	buffer_text(out, "\n");
+}
+
+static _Bool cache_output(const char* path, const char* pack) {
+	for (int i = 0; i < g_job_count; ++i) {
+		if (strcmp(g_jobs[i].output, path) == 0) {
+			return 1;
+		}
+	}
+	return pack != NULL && strcmp(pack, path) == 0;
+}
+
+// packs every sheet in order into an indexed pack the engine loads as pages
+static void pack_write(const char* path) {
+	int sheets = 0;
+	for (int i = 0; i < g_job_count; ++i) {
+		sheets += g_jobs[i].type == JOB_DDS;
+	}
+
+	buffer_t out = {0};
+	buffer_u32(&out, PREBUILD_INDEXED);
+	buffer_u8(&out, sheets >> 8);
+	buffer_u8(&out, sheets & 0xFF);
+	uint32_t offset = out.length + sheets * 9;
+	for (int i = 0; i < g_job_count; ++i) {
+		if (g_jobs[i].type == JOB_DDS) {
+			buffer_u8(&out, g_video);
+			buffer_u32(&out, offset);
+			buffer_u32(&out, g_jobs[i].chunk.length);
+			offset += g_jobs[i].chunk.length;
+		}
+	}
+	for (int i = 0; i < g_job_count; ++i) {
+		if (g_jobs[i].type == JOB_DDS) {
+			buffer_write(&out, g_jobs[i].chunk.data, g_jobs[i].chunk.length);
+		}
+	}
+	buffer_u8(&out, BEE__CHUNK_END);
+	prebuild_replace(path, &out);
+	mint_info("PREBUILD: %i sheets -> '%s'", sheets, path);
+	buffer_free(&out);
+}
+
+int main(int argc, char* argv[]) {
+	bee__option_init(argc, argv);
+	mint_init("prebuild.log");
+
+	const char* list = bee__option_get("list");
+	const char* pack = bee__option_get("pack");
+	const char* cache = bee__option_get("cache");
+	if (cache == NULL) {
+		cache = "prebuild.cache";
+	}
+	_Bool force = bee__option_get("force") != NULL;
+	if (bee__option_get("lz") != NULL) {
+		g_video |= BEE__CHUNK_LZ;
+	}
+	int threads = bee__thread_cores();
+	const char* option = bee__option_get("threads");
+	if (option != NULL) {
+		threads = atoi(option);
+		if (threads <= 0) {
+			mint_fail("PREBUILD: Invalid threads '%s'", option);
+		}
+	}
+	bee__option_check();
+
+	if (list == NULL) {
+		for (size_t i = 0; i < sizeof(g_defaults) / sizeof(*g_defaults); i += 2) {
+			job_add(g_defaults[i], g_defaults[i + 1]);
+		}
+	} else {
+		job_list(list);
+	}
+
+	// outputs are rebuilt when what they were built from changes or they have gone missing
+	cache_load(cache);
+	uint64_t version = PREBUILD_VERSION;
+	uint64_t pack_hash = prebuild_hash(0xCBF29CE484222325, &version, sizeof(version));
+	for (int i = 0; i < g_job_count; ++i) {
+		job_t* job = g_jobs + i;
+		job->file = bee__file_map(job->input);
+		if (job->file == NULL) {
+			mint_fail("PREBUILD: Failed to open '%s'", job->input);
+		}
+		job->hash = prebuild_hash(0xCBF29CE484222325, &version, sizeof(version));
+		job->hash = prebuild_hash(job->hash, job->var, strlen(job->var) + 1);
+		job->hash = prebuild_hash(job->hash, job->file->data, job->file->length);
+		if (job->type == JOB_DDS) {
+			// switching encodings rebuilds the sheets
+			job->hash = prebuild_hash(job->hash, &g_video, 1);
+			pack_hash = prebuild_hash(pack_hash, &job->hash, sizeof(job->hash));
+		}
+		job->write = force || !cache_fresh(job->output, job->hash);
+		job->encode = job->write;
+	}
+	_Bool repack = pack != NULL && (force || !cache_fresh(pack, pack_hash));
+	int count = 0;
+	for (int i = 0; i < g_job_count; ++i) {
+		if (repack && g_jobs[i].type == JOB_DDS) {
+			g_jobs[i].encode = 1;
+		}
+		count += g_jobs[i].write;
+	}
+
+	// files are converted in parallel, this thread takes its share
+	void* workers[PREBUILD_WORKERS];
+	int worker_count = threads - 1 < PREBUILD_WORKERS ? threads - 1 : PREBUILD_WORKERS;
+	atomic_store(&g_job_next, 0);
+	for (int i = 0; i < worker_count; ++i) {
+		workers[i] = bee__thread_create(worker_main, NULL);
+	}
+	worker_main(NULL);
+	for (int i = 0; i < worker_count; ++i) {
+		bee__thread_join(workers[i]);
+	}
+
+	if (repack) {
+		pack_write(pack);
+	}
+
+	// lines for outputs of other lists are kept so switching between them stays incremental
+	buffer_t out = {0};
+	for (int i = 0; i < g_cache_count; ++i) {
+		if (!cache_output(g_cache[i].path, pack)) {
+			cache_line(&out, g_cache[i].path, g_cache[i].hash);
+		}
+	}
+	for (int i = 0; i < g_job_count; ++i) {
+		cache_line(&out, g_jobs[i].output, g_jobs[i].hash);
+	}
+	if (pack != NULL) {
+		cache_line(&out, pack, pack_hash);
+	}
+	prebuild_replace(cache, &out);
+	buffer_free(&out);
+
+	mint_info("PREBUILD: %i of %i files converted, %i threads", count, g_job_count, worker_count + 1);
+	return 0;
+}
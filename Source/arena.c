@@ -0,0 +1,106 @@
+/*
+ * arena.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arena.h"
+#include "profile.h"
+#include <mint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN 16
+#define ARENA_MIN 0x10000
+
+// blocks past the first only exist until the reset folds them into a larger first block
+typedef struct block_t {
+	struct block_t* next;
+	int capacity;
+	int used;
+	_Alignas(ARENA_ALIGN) unsigned char data[];
+} block_t;
+
+static block_t* g_block;
+static int g_total = 0;
+static void* g_last;
+
+static int arena_align(int size) {
+	return (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+static block_t* arena_block(block_t* next, int capacity) {
+	block_t* block = malloc(sizeof(block_t) + capacity);
+	block->next = next;
+	block->capacity = capacity;
+	block->used = 0;
+	return block;
+}
+
+void* bee__arena_alloc(int size) {
+	size = arena_align(size);
+	if (g_block == NULL || g_block->used + size > g_block->capacity) {
+		int capacity = g_block == NULL ? ARENA_MIN : g_block->capacity * 2;
+		while (capacity < size) {
+			capacity *= 2;
+		}
+		g_block = arena_block(g_block, capacity);
+	}
+
+	g_last = g_block->data + g_block->used;
+	g_block->used += size;
+	g_total += size;
+	return g_last;
+}
+
+void* bee__arena_grow(void* data, int size, int new_size) {
+	size = arena_align(size);
+	int extra = arena_align(new_size) - size;
+	if (data != NULL && data == g_last && g_block->used + extra <= g_block->capacity) {
+		g_block->used += extra;
+		g_total += extra;
+		return data;
+	}
+
+	void* result = bee__arena_alloc(new_size);
+	if (data != NULL) {
+		memcpy(result, data, size);
+	}
+	return result;
+}
+
+void bee__arena_reset() {
+	bee__profile_count(BEE__PROFILE_ARENA, g_total);
+	if (g_block != NULL && g_block->next != NULL) {
+		// the next frame gets one block that would have held all of this one
+		int capacity = g_block->capacity;
+		while (capacity < g_total) {
+			capacity *= 2;
+		}
+		while (g_block != NULL) {
+			block_t* next = g_block->next;
+			free(g_block);
+			g_block = next;
+		}
+		g_block = arena_block(NULL, capacity);
+		mint_info("ARENA: Grew to %i bytes", capacity);
+	}
+
+	if (g_block != NULL) {
+		g_block->used = 0;
+	}
+	g_total = 0;
+	g_last = NULL;
+}
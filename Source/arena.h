@@ -0,0 +1,29 @@
+/*
+ * arena.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+// memory that only lives for the current frame, everything is taken back at once by the reset
+void* bee__arena_alloc(int size);
+// extends the latest allocation in place when it can, otherwise copies it somewhere larger
+void* bee__arena_grow(void* data, int size, int new_size);
+// called once the frame is presented, no earlier allocation may be used after it
+void bee__arena_reset();
+
+#endif
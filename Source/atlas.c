@@ -0,0 +1,261 @@
+/*
+ * atlas.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "atlas.h"
+#include "video.h"
+#include "transform.h"
+#include "profile.h"
+#include "arena.h"
+#include <8bee.h>
+#include <mint.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// how many batches a sprite may move back past to join one with the same page
+#define ATLAS_LOOKBACK 16
+
+// bounds are in 16.16 canvas pixels like the matrix translation
+typedef struct bounds_t {
+	int64_t x0, y0, x1, y1;
+} bounds_t;
+
+typedef struct elem_t {
+	bee_sprite_t sprite;
+	bee__matrix_t matrix;
+	int next;
+} elem_t;
+
+// pages start out indexed and only get a colour texture if they are mapped that way
+typedef struct page_t {
+	void* direct;
+	void* indexed;
+	void* current;
+	void (*load)(int data);
+	int load_data;
+} page_t;
+
+typedef struct batch_t {
+	int page;
+	int head;
+	int tail;
+	bounds_t bounds;
+} batch_t;
+
+static page_t* g_pages;
+static int g_page_count = 0;
+
+// fingerprint of the last drawn frame, pages changing forces a redraw
+static uint64_t g_hash;
+static int g_hash_count = -1;
+static _Bool g_dirty = 1;
+
+// the frame's sprites live in the frame arena, sized from the last frame so they rarely move
+static elem_t* g_elems;
+static int g_elem_count = 0;
+static int g_elem_capacity = 0;
+static int g_elem_hint = 0;
+static batch_t* g_batches;
+static int g_batch_count = 0;
+static int g_batch_capacity = 0;
+static int g_batch_hint = 0;
+
+int bee__atlas_alloc() {
+	mint_array_check(g_pages, g_page_count + 1);
+	page_t* page = g_pages + g_page_count;
+	page->direct = NULL;
+	page->indexed = bee__video_index_create(128, 128);
+	page->current = page->indexed;
+	page->load = NULL;
+	return g_page_count++;
+}
+
+int bee__atlas_count() {
+	return g_page_count;
+}
+
+void bee__atlas_defer(int page, void (*load)(int data), int data) {
+	g_pages[page].load = load;
+	g_pages[page].load_data = data;
+}
+
+unsigned short* bee__atlas_map(int page) {
+	page_t* dst = g_pages + page;
+	if (dst->direct == NULL) {
+		dst->direct = bee__video_texture_create(128, 128, NULL);
+	}
+	dst->current = dst->direct;
+	return bee__video_texture_map(dst->direct);
+}
+
+unsigned char* bee__atlas_map_indexed(int page) {
+	page_t* dst = g_pages + page;
+	dst->current = dst->indexed;
+	return bee__video_index_map(dst->indexed);
+}
+
+void bee__atlas_unmap(int page) {
+	page_t* dst = g_pages + page;
+	if (dst->current == dst->indexed) {
+		bee__video_index_unmap(dst->indexed);
+	} else {
+		bee__video_texture_unmap(dst->direct);
+	}
+	g_dirty = 1;
+}
+
+void bee__atlas_palette(int index, int count, const unsigned short* colors) {
+	bee__video_palette(index, count, colors);
+	g_dirty = 1;
+}
+
+void bee_palette(int index, int count, const unsigned short* colors) {
+	if (index < 0 || count < 0 || index + count > BEE_PALETTE_SIZE) {
+		mint_fail("ATLAS: Invalid palette range %i+%i", index, count);
+	}
+	bee__atlas_palette(index, count, colors);
+}
+
+static bounds_t atlas_bounds(const bee_sprite_t* sprite, const bee__matrix_t* matrix) {
+	int64_t ax = llabs((int64_t)matrix->m00 * sprite->w) + llabs((int64_t)matrix->m01 * sprite->h);
+	int64_t ay = llabs((int64_t)matrix->m10 * sprite->w) + llabs((int64_t)matrix->m11 * sprite->h);
+	bounds_t bounds = {
+			matrix->m02 - ax / 2, matrix->m12 - ay / 2,
+			matrix->m02 + ax / 2, matrix->m12 + ay / 2
+	};
+	return bounds;
+}
+
+static _Bool atlas_overlap(const bounds_t* a, const bounds_t* b) {
+	return a->x0 < b->x1 && b->x0 < a->x1 && a->y0 < b->y1 && b->y0 < a->y1;
+}
+
+static void atlas_merge(bounds_t* a, const bounds_t* b) {
+	if (b->x0 < a->x0) {
+		a->x0 = b->x0;
+	}
+	if (b->y0 < a->y0) {
+		a->y0 = b->y0;
+	}
+	if (b->x1 > a->x1) {
+		a->x1 = b->x1;
+	}
+	if (b->y1 > a->y1) {
+		a->y1 = b->y1;
+	}
+}
+
+_Bool bee__atlas_changed() {
+	// FNV-1a over the sprites and matrices a word at a time
+	uint64_t hash = 0xCBF29CE484222325;
+	for (int i = 0; i < g_elem_count; ++i) {
+		const uint32_t* words = (const uint32_t*)&g_elems[i].sprite;
+		for (size_t j = 0; j < sizeof(bee_sprite_t) / 4; ++j) {
+			hash = (hash ^ words[j]) * 0x100000001B3;
+		}
+		words = (const uint32_t*)&g_elems[i].matrix;
+		for (size_t j = 0; j < sizeof(bee__matrix_t) / 4; ++j) {
+			hash = (hash ^ words[j]) * 0x100000001B3;
+		}
+	}
+
+	_Bool changed = g_dirty || hash != g_hash || g_elem_count != g_hash_count;
+	g_hash = hash;
+	g_hash_count = g_elem_count;
+	g_dirty = 0;
+	return changed;
+}
+
+static void* atlas_grow(void* data, int* capacity, int hint, int size) {
+	int grown = *capacity > 0 ? *capacity * 2 : hint > 16 ? hint : 16;
+	data = bee__arena_grow(data, *capacity * size, grown * size);
+	*capacity = grown;
+	return data;
+}
+
+static void atlas_end() {
+	g_elem_hint = g_elem_count;
+	g_elems = NULL;
+	g_elem_count = 0;
+	g_elem_capacity = 0;
+	g_batch_hint = g_batch_count;
+	g_batches = NULL;
+	g_batch_count = 0;
+	g_batch_capacity = 0;
+}
+
+void bee__atlas_discard() {
+	atlas_end();
+}
+
+void bee__atlas_flush() {
+	for (int i = 0; i < g_batch_count; ++i) {
+		batch_t* batch = g_batches + i;
+		void* texture = g_pages[batch->page].current;
+		for (int j = batch->head; j != -1; j = g_elems[j].next) {
+			bee__video_texture_draw(texture, &g_elems[j].sprite, &g_elems[j].matrix);
+		}
+	}
+	atlas_end();
+}
+
+void bee_draw(const bee_sprite_t* sprite) {
+	if (sprite->page < 0 || sprite->page >= g_page_count) {
+		mint_fail("ATLAS: Invalid page %i", sprite->page);
+	}
+	page_t* page = g_pages + sprite->page;
+	if (page->load != NULL) {
+		void (*load)(int data) = page->load;
+		page->load = NULL;
+		load(page->load_data);
+	}
+	bee__profile_count(BEE__PROFILE_SPRITES, 1);
+
+	if (g_elem_count == g_elem_capacity) {
+		g_elems = atlas_grow(g_elems, &g_elem_capacity, g_elem_hint, sizeof(elem_t));
+	}
+	int index = g_elem_count++;
+	elem_t* elem = g_elems + index;
+	elem->sprite = *sprite;
+	elem->matrix = *bee__transform_get();
+	elem->next = -1;
+	bounds_t bounds = atlas_bounds(sprite, &elem->matrix);
+
+	// sprites can only be drawn earlier if they do not overlap anything they move past
+	int last = g_batch_count - ATLAS_LOOKBACK;
+	for (int i = g_batch_count - 1; i >= 0 && i >= last; --i) {
+		batch_t* batch = g_batches + i;
+		if (batch->page == sprite->page) {
+			g_elems[batch->tail].next = index;
+			batch->tail = index;
+			atlas_merge(&batch->bounds, &bounds);
+			return;
+		}
+		if (atlas_overlap(&batch->bounds, &bounds)) {
+			break;
+		}
+	}
+
+	if (g_batch_count == g_batch_capacity) {
+		g_batches = atlas_grow(g_batches, &g_batch_capacity, g_batch_hint, sizeof(batch_t));
+	}
+	batch_t* batch = g_batches + g_batch_count++;
+	batch->page = sprite->page;
+	batch->head = index;
+	batch->tail = index;
+	batch->bounds = bounds;
+}
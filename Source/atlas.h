@@ -0,0 +1,41 @@
+/*
+ * atlas.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ATLAS_H_
+#define ATLAS_H_
+
+// pages are 128x128 textures that sprites select with bee_sprite_t::page,
+// mapping a page one way or the other decides whether it holds colours or palette indices
+int bee__atlas_alloc();
+int bee__atlas_count();
+// load is called with data the first time a sprite is drawn from the page, unused pages are never filled
+void bee__atlas_defer(int page, void (*load)(int data), int data);
+unsigned short* bee__atlas_map(int page);
+unsigned char* bee__atlas_map_indexed(int page);
+void bee__atlas_unmap(int page);
+// replaces count of the 256 palette entries starting at index
+void bee__atlas_palette(int index, int count, const unsigned short* colors);
+
+// fingerprints the frame's sprites, returns 0 if they and the pages match the last frame
+_Bool bee__atlas_changed();
+// submits the frame's sprites grouped by page
+void bee__atlas_flush();
+// drops the frame's sprites without drawing them
+void bee__atlas_discard();
+
+#endif
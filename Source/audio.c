@@ -0,0 +1,289 @@
+/*
+ * audio.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audio.h"
+#include "clip.h"
+#include "thread.h"
+#include "clock.h"
+#include "option.h"
+#include <8bee.h>
+#include <mint.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// commands and events that can be in flight between the threads, must be a power of two
+#define AUDIO_QUEUE 256
+
+// voices are allocated by the game thread and handed back to it once finished,
+// so the mixer only links and unlinks them
+typedef struct voice_t {
+	const bee_clip_t* clip;
+	bee_callback_t end;
+	bee__clip_state_t state;
+	struct voice_t* next;
+} voice_t;
+
+// single producer single consumer ring
+typedef struct queue_t {
+	atomic_uint head;
+	atomic_uint tail;
+	voice_t* items[AUDIO_QUEUE];
+} queue_t;
+
+typedef struct sink_t {
+	const char* name;
+	void (*write)(const int16_t* data, int count);
+	void (*close)();
+} sink_t;
+
+static queue_t g_commands;
+static queue_t g_events;
+static void* g_thread;
+static atomic_bool g_running;
+
+static const sink_t* g_sink;
+static int g_block = 256;
+static long long g_latency = 20000000;
+
+// only touched by the game thread
+static voice_t* g_free;
+static voice_t** g_voices;
+static int g_voice_count = 0;
+
+// only touched by the mixer thread
+static voice_t* g_playing;
+static int* g_mix;
+static int16_t* g_output;
+static int g_blocks = 0;
+static int g_late = 0;
+static long long g_mix_max = 0;
+
+static FILE* g_wav;
+static uint32_t g_wav_length = 0;
+
+static _Bool queue_push(queue_t* queue, voice_t* voice) {
+	unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+	if (tail - head == AUDIO_QUEUE) {
+		return 0;
+	}
+	queue->items[tail % AUDIO_QUEUE] = voice;
+	atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+	return 1;
+}
+
+static _Bool queue_pop(queue_t* queue, voice_t** voice) {
+	unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+	if (head == tail) {
+		return 0;
+	}
+	*voice = queue->items[head % AUDIO_QUEUE];
+	atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+	return 1;
+}
+
+static void sink_null_write(const int16_t* data, int count) {
+}
+
+static void sink_null_close() {
+}
+
+static void wav_write16(uint16_t value) {
+	fputc(value & 0xFF, g_wav);
+	fputc(value >> 8, g_wav);
+}
+
+static void wav_write32(uint32_t value) {
+	wav_write16(value & 0xFFFF);
+	wav_write16(value >> 16);
+}
+
+static void wav_header() {
+	fwrite("RIFF", 1, 4, g_wav);
+	wav_write32(36 + g_wav_length);
+	fwrite("WAVEfmt ", 1, 8, g_wav);
+	wav_write32(16);
+	wav_write16(1);
+	wav_write16(1);
+	wav_write32(BEE__AUDIO_RATE);
+	wav_write32(BEE__AUDIO_RATE * 2);
+	wav_write16(2);
+	wav_write16(16);
+	fwrite("data", 1, 4, g_wav);
+	wav_write32(g_wav_length);
+}
+
+static void sink_wav_write(const int16_t* data, int count) {
+	for (int i = 0; i < count; ++i) {
+		wav_write16(data[i]);
+	}
+	g_wav_length += count * 2;
+}
+
+static void sink_wav_close() {
+	fseek(g_wav, 0, SEEK_SET);
+	wav_header();
+	fclose(g_wav);
+}
+
+static const sink_t g_sink_null = {"null", sink_null_write, sink_null_close};
+static const sink_t g_sink_wav = {"wav", sink_wav_write, sink_wav_close};
+
+static void audio_mix() {
+	for (int i = 0; i < g_block; ++i) {
+		g_mix[i] = 0;
+	}
+
+	for (voice_t** link = &g_playing; *link != NULL;) {
+		voice_t* voice = *link;
+		int left = bee__clip_mix(&voice->state, voice->clip, g_mix, g_block);
+
+		// finished voices stay around until the game thread has room for the event
+		if (left == 0 && queue_push(&g_events, voice)) {
+			*link = voice->next;
+		} else {
+			link = &voice->next;
+		}
+	}
+
+	for (int i = 0; i < g_block; ++i) {
+		int value = g_mix[i];
+		if (value > INT16_MAX) {
+			value = INT16_MAX;
+		} else if (value < INT16_MIN) {
+			value = INT16_MIN;
+		}
+		g_output[i] = value;
+	}
+}
+
+static void audio_thread(void* data) {
+	long long block = (long long)g_block * 1000000000 / BEE__AUDIO_RATE;
+	long long next = bee__clock_get();
+	while (atomic_load_explicit(&g_running, memory_order_relaxed)) {
+		voice_t* voice;
+		while (queue_pop(&g_commands, &voice)) {
+			voice->next = g_playing;
+			g_playing = voice;
+		}
+
+		long long begin = bee__clock_get();
+		audio_mix();
+		g_sink->write(g_output, g_block);
+		long long end = bee__clock_get();
+		if (end - begin > g_mix_max) {
+			g_mix_max = end - begin;
+		}
+		++g_blocks;
+
+		// stay at most the latency ahead of playback
+		next += block;
+		if (end > next) {
+			++g_late;
+			next = end;
+		} else if (next - end > g_latency) {
+			bee__clock_sleep(next - end - g_latency);
+		}
+	}
+}
+
+static void audio_destroy(void* data) {
+	atomic_store(&g_running, 0);
+	bee__thread_join(g_thread);
+	g_sink->close();
+	mint_info("AUDIO: %i blocks, %i late, longest mix %lli us", g_blocks, g_late, g_mix_max / 1000);
+	free(g_mix);
+	free(g_output);
+	for (int i = 0; i < g_voice_count; ++i) {
+		free(g_voices[i]);
+	}
+}
+
+static int audio_option(const char* name, int value) {
+	const char* option = bee__option_get(name);
+	if (option != NULL) {
+		value = atoi(option);
+		if (value <= 0) {
+			mint_fail("AUDIO: Invalid %s '%s'", name, option);
+		}
+	}
+	return value;
+}
+
+void bee__audio_init() {
+	g_block = audio_option("block", g_block);
+	g_latency = audio_option("latency", g_latency / 1000000) * 1000000LL;
+
+	g_sink = &g_sink_null;
+	const char* path = bee__option_get("wav");
+	if (path != NULL) {
+		g_wav = fopen(path, "wb");
+		if (g_wav == NULL) {
+			mint_fail("AUDIO: Failed to open '%s'", path);
+		}
+		wav_header();
+		g_sink = &g_sink_wav;
+	}
+
+	g_mix = malloc(g_block * sizeof(int));
+	g_output = malloc(g_block * sizeof(int16_t));
+	atomic_store(&g_running, 1);
+	g_thread = bee__thread_create(audio_thread, NULL);
+	mint_create(&g_thread, audio_destroy);
+	mint_info("AUDIO: %s sink, %i sample blocks, %lli ms latency", g_sink->name, g_block, g_latency / 1000000);
+}
+
+static void audio_free(voice_t* voice) {
+	voice->next = g_free;
+	g_free = voice;
+}
+
+void bee__audio_update() {
+	voice_t* voice;
+	while (queue_pop(&g_events, &voice)) {
+		// freed first so the callback can play the next clip with it
+		const bee_clip_t* clip = voice->clip;
+		bee_callback_t end = voice->end;
+		audio_free(voice);
+		if (end != NULL) {
+			end((void*)clip);
+		}
+	}
+}
+
+void bee_play(const bee_clip_t* clip, bee_callback_t end) {
+	voice_t* voice = g_free;
+	if (voice != NULL) {
+		g_free = voice->next;
+	} else {
+		voice = malloc(sizeof(voice_t));
+		mint_array_check(g_voices, g_voice_count + 1);
+		g_voices[g_voice_count++] = voice;
+	}
+	voice->clip = clip;
+	voice->end = end;
+	memset(&voice->state, 0, sizeof(bee__clip_state_t));
+	if (!queue_push(&g_commands, voice)) {
+		audio_free(voice);
+		mint_warn("AUDIO: Too many clips queued");
+	}
+}
@@ -0,0 +1,29 @@
+/*
+ * audio.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AUDIO_H_
+#define AUDIO_H_
+
+// mono 16-bit output at a fixed rate
+#define BEE__AUDIO_RATE 44100
+
+void bee__audio_init();
+// fires the end callbacks of clips that finished since the last update
+void bee__audio_update();
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ * chunk.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "chunk.h"
+#include <stdint.h>
+#include <string.h>
+
+// positions are found through chains of earlier positions with the same three pixel hash
+#define CHUNK_HASH 0x1000
+#define CHUNK_DEPTH 64
+
+typedef struct chunk_t {
+	const unsigned short* pixels;
+	unsigned char* out;
+	int length;
+	int16_t head[CHUNK_HASH];
+	int16_t chain[BEE__CHUNK_PIXELS];
+} chunk_t;
+
+// resource colours have every channel at 0, 5, A or F and are fully opaque, apart from clear
+static int chunk_index(uint16_t color) {
+	if (color == 0) {
+		return 0;
+	}
+	int index = 0;
+	for (int i = 12; i >= 4; i -= 4) {
+		int value = (color >> i) & 0xF;
+		if (value % 5 != 0 || (color & 0xF) != 0xF) {
+			return -1;
+		}
+		index = index * 4 + value / 5;
+	}
+	// opaque black is not one of them as index 0 is clear
+	return index > 0 ? index : -1;
+}
+
+static void chunk_color(chunk_t* chunk, uint16_t color) {
+	int index = chunk_index(color);
+	if (index >= 0) {
+		chunk->out[chunk->length++] = index;
+	} else {
+		chunk->out[chunk->length++] = (color >> 12) | BEE__CHUNK_LITERAL;
+		chunk->out[chunk->length++] = (color >> 4) & 0xFF;
+	}
+}
+
+static void chunk_run(chunk_t* chunk, int count) {
+	for (; count > 0; count -= 128) {
+		chunk->out[chunk->length++] = ((count > 128 ? 128 : count) - 1) | BEE__CHUNK_RUN;
+	}
+}
+
+static void chunk_match(chunk_t* chunk, int count, int distance) {
+	if (count >= BEE__CHUNK_MATCH_LONG) {
+		chunk->out[chunk->length++] = 0x7F;
+		chunk->out[chunk->length++] = count - BEE__CHUNK_MATCH_LONG;
+	} else {
+		chunk->out[chunk->length++] = BEE__CHUNK_MATCH + count - BEE__CHUNK_MATCH_MIN;
+	}
+	distance -= 1;
+	if (distance < 0x80) {
+		chunk->out[chunk->length++] = distance;
+	} else {
+		chunk->out[chunk->length++] = (distance >> 8) | 0x80;
+		chunk->out[chunk->length++] = distance & 0xFF;
+	}
+}
+
+static int chunk_hash(const unsigned short* pixels) {
+	uint32_t hash = pixels[0] * 0x9E3779B1 ^ pixels[1] * 0x85EBCA6B ^ pixels[2] * 0xC2B2AE35;
+	return (hash >> 16) & (CHUNK_HASH - 1);
+}
+
+static void chunk_insert(chunk_t* chunk, int position) {
+	if (position + BEE__CHUNK_MATCH_MIN <= BEE__CHUNK_PIXELS) {
+		int hash = chunk_hash(chunk->pixels + position);
+		chunk->chain[position] = chunk->head[hash];
+		chunk->head[hash] = position;
+	}
+}
+
+// finds the longest earlier copy of the pixels at position, ignoring runs which are cheaper as they are
+static int chunk_find(chunk_t* chunk, int position, int* distance) {
+	const unsigned short* pixels = chunk->pixels;
+	int limit = BEE__CHUNK_PIXELS - position;
+	if (limit > BEE__CHUNK_MATCH_MAX) {
+		limit = BEE__CHUNK_MATCH_MAX;
+	}
+	if (limit < BEE__CHUNK_MATCH_MIN) {
+		return 0;
+	}
+
+	int best = 0;
+	int candidate = chunk->head[chunk_hash(pixels + position)];
+	for (int depth = 0; depth < CHUNK_DEPTH && candidate >= 0; ++depth) {
+		int back = position - candidate;
+		if (back > 1 && back <= BEE__CHUNK_DISTANCE_MAX) {
+			int count = 0;
+			while (count < limit && pixels[candidate + count] == pixels[position + count]) {
+				++count;
+			}
+			// far copies cost an extra byte so short ones are not worth it
+			if (count > best && (back <= 0x80 || count > BEE__CHUNK_MATCH_MIN)) {
+				best = count;
+				*distance = back;
+				if (count == limit) {
+					break;
+				}
+			}
+		}
+		candidate = chunk->chain[candidate];
+	}
+	return best >= BEE__CHUNK_MATCH_MIN ? best : 0;
+}
+
+int bee__chunk_encode(const unsigned short* pixels, _Bool lz, unsigned char* out) {
+	static _Thread_local chunk_t chunk;
+	chunk.pixels = pixels;
+	chunk.out = out;
+	chunk.length = 0;
+	memset(chunk.head, 0xFF, sizeof(chunk.head));
+
+	for (int i = 0; i < BEE__CHUNK_PIXELS;) {
+		int run = 0;
+		if (i > 0) {
+			while (i + run < BEE__CHUNK_PIXELS && pixels[i + run] == pixels[i - 1]) {
+				++run;
+			}
+		}
+		int distance = 0;
+		int count = lz ? chunk_find(&chunk, i, &distance) : 0;
+
+		int step;
+		if (run > 0 && run >= count) {
+			chunk_run(&chunk, run);
+			step = run;
+		} else if (count > 0) {
+			chunk_match(&chunk, count, distance);
+			step = count;
+		} else {
+			chunk_color(&chunk, pixels[i]);
+			step = 1;
+		}
+		if (lz) {
+			for (int j = 0; j < step; ++j) {
+				chunk_insert(&chunk, i + j);
+			}
+		}
+		i += step;
+	}
+	return chunk.length;
+}
@@ -0,0 +1,46 @@
+/*
+ * chunk.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CHUNK_H_
+#define CHUNK_H_
+
+// video chunks are 128x128 RGBA4444 pixels encoded as a stream of byte tokens
+#define BEE__CHUNK_PIXELS (128 * 128)
+// no encoding needs more than a two byte literal for every pixel
+#define BEE__CHUNK_MAX (BEE__CHUNK_PIXELS * 2)
+
+// chunk types, compressed chunks set BEE__CHUNK_LZ on top of their type
+#define BEE__CHUNK_VIDEO 0x15
+#define BEE__CHUNK_END 0x1A
+#define BEE__CHUNK_LZ 0x80
+
+// tokens shared by both encodings
+#define BEE__CHUNK_LITERAL 0x40
+#define BEE__CHUNK_RUN 0x80
+// compressed chunks only, 0x50 + length - 3, a length byte if that is 0x7F,
+// then the distance back - 1 in one byte below 0x80 or two with the top bit set
+#define BEE__CHUNK_MATCH 0x50
+#define BEE__CHUNK_MATCH_MIN 3
+#define BEE__CHUNK_MATCH_LONG (0x7F - BEE__CHUNK_MATCH + BEE__CHUNK_MATCH_MIN)
+#define BEE__CHUNK_MATCH_MAX (BEE__CHUNK_MATCH_LONG + 0xFF)
+#define BEE__CHUNK_DISTANCE_MAX 0x8000
+
+// encodes pixels into out, back-references are only used if lz is set, returns the length in bytes
+int bee__chunk_encode(const unsigned short* pixels, _Bool lz, unsigned char* out);
+
+#endif
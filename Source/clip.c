@@ -0,0 +1,208 @@
+/*
+ * clip.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "clip.h"
+#include "audio.h"
+#include <stdint.h>
+
+static const int16_t g_adpcm_steps[89] = {
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+	253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+	1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+	3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+	11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+	32767
+};
+
+static const int8_t g_adpcm_indices[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+static void clip_int(bee__clip_state_t* state, const bee_clip_t* clip, int* buffer, int count) {
+	const int* samples = clip->samples + state->position;
+	for (int i = 0; i < count; ++i) {
+		buffer[i] += samples[i];
+	}
+}
+
+static void clip_pcm8(bee__clip_state_t* state, const bee_clip_t* clip, int* buffer, int count) {
+	const int8_t* samples = (const int8_t*)clip->data + state->position;
+	for (int i = 0; i < count; ++i) {
+		buffer[i] += samples[i] * 256;
+	}
+}
+
+// applies one nibble to the predictor and step index
+static void clip_adpcm_step(int* predictor, int* index, int nibble) {
+	int step = g_adpcm_steps[*index];
+	int delta = step >> 3;
+	if (nibble & 4) {
+		delta += step;
+	}
+	if (nibble & 2) {
+		delta += step >> 1;
+	}
+	if (nibble & 1) {
+		delta += step >> 2;
+	}
+	*predictor += (nibble & 8) ? -delta : delta;
+	if (*predictor > INT16_MAX) {
+		*predictor = INT16_MAX;
+	} else if (*predictor < INT16_MIN) {
+		*predictor = INT16_MIN;
+	}
+
+	*index += g_adpcm_indices[nibble & 7];
+	if (*index < 0) {
+		*index = 0;
+	} else if (*index > 88) {
+		*index = 88;
+	}
+}
+
+static void clip_adpcm4(bee__clip_state_t* state, const bee_clip_t* clip, int* buffer, int count) {
+	const uint8_t* data = clip->data;
+	int predictor = state->predictor;
+	int index = state->index;
+	for (int i = 0; i < count; ++i) {
+		int position = state->position + i;
+		int nibble = (data[position / 2] >> ((position & 1) * 4)) & 0xF;
+		clip_adpcm_step(&predictor, &index, nibble);
+		buffer[i] += predictor;
+	}
+	state->predictor = predictor;
+	state->index = index;
+}
+
+static int clip_wave(bee__clip_state_t* state, bee_wave_t wave, uint32_t step) {
+	uint32_t phase = state->phase;
+	state->phase += step;
+	switch (wave) {
+	case BEE_WAVE_SQUARE:
+		return phase < 0x80000000 ? INT16_MAX : -INT16_MAX;
+	case BEE_WAVE_PULSE:
+		return phase < 0x40000000 ? INT16_MAX : -INT16_MAX;
+	case BEE_WAVE_TRIANGLE:
+		phase >>= 15;
+		return phase < 0x10000 ? (int)phase - 0x8000 : 0x17FFF - (int)phase;
+	case BEE_WAVE_SAW:
+		return (int)(phase >> 16) - 0x8000;
+	case BEE_WAVE_NOISE:
+		// 15-bit LFSR clocked once per period
+		if (state->phase < phase) {
+			unsigned int bit = (state->noise ^ (state->noise >> 1)) & 1;
+			state->noise = (state->noise >> 1) | (bit << 14);
+		}
+		return (state->noise & 1) ? INT16_MAX : -INT16_MAX;
+	}
+	return 0;
+}
+
+static void clip_synth(bee__clip_state_t* state, const bee_clip_t* clip, int* buffer, int count) {
+	const bee_synth_t* synth = clip->data;
+	if (state->noise == 0) {
+		state->noise = 1;
+	}
+
+	int i = 0;
+	while (i < count && state->note < synth->count) {
+		const bee_note_t* note = synth->notes + state->note;
+		int length = note->length - state->note_position;
+		if (length > count - i) {
+			length = count - i;
+		}
+
+		if (note->frequency > 0) {
+			uint32_t step = ((uint64_t)note->frequency << 32) / BEE__AUDIO_RATE;
+			for (int j = 0; j < length; ++j) {
+				int t = state->note_position + j;
+				int volume = synth->volume;
+				if (t < synth->attack) {
+					volume = volume * t / synth->attack;
+				}
+				if (note->length - t < synth->release) {
+					volume = volume * (note->length - t) / synth->release;
+				}
+				buffer[i + j] += clip_wave(state, synth->wave, step) * volume / 0x8000;
+			}
+		}
+
+		i += length;
+		state->note_position += length;
+		if (state->note_position == note->length) {
+			state->note_position = 0;
+			state->phase = 0;
+			++state->note;
+		}
+	}
+}
+
+int bee__clip_mix(bee__clip_state_t* state, const bee_clip_t* clip, int* buffer, int count) {
+	int left = clip->length - state->position;
+	if (count > left) {
+		count = left;
+	}
+
+	switch (clip->format) {
+	case BEE_FORMAT_INT:
+		clip_int(state, clip, buffer, count);
+		break;
+	case BEE_FORMAT_PCM8:
+		clip_pcm8(state, clip, buffer, count);
+		break;
+	case BEE_FORMAT_ADPCM4:
+		clip_adpcm4(state, clip, buffer, count);
+		break;
+	case BEE_FORMAT_SYNTH:
+		clip_synth(state, clip, buffer, count);
+		break;
+	}
+	state->position += count;
+	return left - count;
+}
+
+void bee__clip_encode(const int* samples, int length, unsigned char* data) {
+	int predictor = 0;
+	int index = 0;
+	for (int i = 0; i < length; ++i) {
+		int step = g_adpcm_steps[index];
+		int diff = samples[i] - predictor;
+		int nibble = 0;
+		if (diff < 0) {
+			nibble = 8;
+			diff = -diff;
+		}
+		if (diff >= step) {
+			nibble |= 4;
+			diff -= step;
+		}
+		if (diff >= step >> 1) {
+			nibble |= 2;
+			diff -= step >> 1;
+		}
+		if (diff >= step >> 2) {
+			nibble |= 1;
+		}
+		clip_adpcm_step(&predictor, &index, nibble);
+
+		if (i & 1) {
+			data[i / 2] |= nibble << 4;
+		} else {
+			data[i / 2] = nibble;
+		}
+	}
+}
@@ -0,0 +1,40 @@
+/*
+ * clip.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CLIP_H_
+#define CLIP_H_
+
+#include <8bee.h>
+
+// decoder state for one playing clip, zero initialised to start from the beginning
+typedef struct bee__clip_state_t {
+	int position;
+	int predictor;
+	int index;
+	unsigned int phase;
+	unsigned int noise;
+	int note;
+	int note_position;
+} bee__clip_state_t;
+
+// adds up to count samples to the buffer and returns how many are left in the clip
+int bee__clip_mix(bee__clip_state_t* state, const bee_clip_t* clip, int* buffer, int count);
+// packs samples as 4-bit ADPCM into (length + 1) / 2 bytes
+void bee__clip_encode(const int* samples, int length, unsigned char* data);
+
+#endif
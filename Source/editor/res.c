@@ -34,5 +34,5 @@ const bee_sprite_t bee__editor_music_font = {96, 40, 8, 8};
 const bee_sprite_t bee__editor_music_corner = {110, 118, 18, 10};
 
 void bee__editor_res_init() {
-	bee__res_data(sizeof(bee__editor_res_editor), bee__editor_res_editor);
+	bee__res_data(sizeof(bee__editor_res_editor), bee__editor_res_editor, 0);
 }
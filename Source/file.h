@@ -0,0 +1,32 @@
+/*
+ * file.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FILE_H_
+#define FILE_H_
+
+typedef struct bee__file_t {
+	const unsigned char* data;
+	int length;
+} bee__file_t;
+
+// maps a file into memory read-only, returns NULL if it can not be opened
+bee__file_t* bee__file_map(const char* path);
+// replaces a file by writing a temporary copy, flushing it to disk and renaming it over
+_Bool bee__file_replace(const char* path, const void* data, int length);
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * frame.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame.h"
+#include "clock.h"
+#include "option.h"
+#include <8bee.h>
+#include <mint.h>
+#include <stdlib.h>
+
+// how far behind we can fall before dropping the missed ticks
+#define FRAME_MAX_LAG 4
+
+// how long before the deadline to stop sleeping and start spinning
+#define FRAME_SPIN 1000000
+
+static long long g_tick;
+static _Bool g_uncapped;
+static _Bool g_spin;
+
+static long long g_next;
+static long long g_begin;
+static bee_frame_t g_frame;
+
+void bee__frame_init() {
+	int rate = 60;
+	const char* option = bee__option_get("rate");
+	if (option != NULL) {
+		rate = atoi(option);
+		if (rate <= 0) {
+			mint_fail("FRAME: Invalid rate '%s'", option);
+		}
+	}
+
+	g_tick = 1000000000LL / rate;
+	g_uncapped = bee__option_get("uncapped") != NULL;
+	g_spin = bee__option_get("spin") != NULL;
+	mint_info("FRAME: %i Hz%s%s", rate, g_uncapped ? " uncapped" : "", g_spin ? " spin" : "");
+
+	g_next = bee__clock_get();
+	g_begin = g_next;
+}
+
+void bee__frame_begin() {
+	long long now = bee__clock_get();
+	if (!g_uncapped) {
+		if (now < g_next) {
+			long long sleep = g_next - now;
+			if (g_spin) {
+				sleep -= FRAME_SPIN;
+			}
+			if (sleep > 0) {
+				bee__clock_sleep(sleep);
+			}
+			do {
+				now = bee__clock_get();
+			} while (g_spin && now < g_next);
+		} else if (now - g_next > g_tick * FRAME_MAX_LAG) {
+			g_next = now;
+		}
+		g_next += g_tick;
+	}
+
+	g_frame.delta = (now - g_begin) / 1000;
+	g_begin = now;
+	++g_frame.count;
+}
+
+void bee__frame_end() {
+	g_frame.work = (bee__clock_get() - g_begin) / 1000;
+}
+
+const bee_frame_t* bee_frame() {
+	return &g_frame;
+}
@@ -17,6 +17,7 @@
  */
 
 #include "context.h"
+#include "../window.h"
 #include <mint.h>
 
 static EGLDisplay g_display;
@@ -73,11 +74,13 @@ void bee__context_init(EGLNativeWindowType window) {
 	mint_create(g_display, display_destroy);
 
 	// config
-	static const EGLint config_attribs[] = {
+	_Bool headless = window == (EGLNativeWindowType)0;
+	const EGLint config_attribs[] = {
 			EGL_RED_SIZE, 2,
 			EGL_GREEN_SIZE, 2,
 			EGL_BLUE_SIZE, 2,
 			EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
+			EGL_SURFACE_TYPE, headless ? EGL_PBUFFER_BIT : EGL_WINDOW_BIT,
 			EGL_NONE
 	};
 
@@ -91,7 +94,16 @@ void bee__context_init(EGLNativeWindowType window) {
 	}
 
 	// surface
-	g_surface = eglCreateWindowSurface(g_display, config, window, NULL);
+	if (headless) {
+		static const EGLint pbuffer_attribs[] = {
+				EGL_WIDTH, BEE__WINDOW_SIZE,
+				EGL_HEIGHT, BEE__WINDOW_SIZE,
+				EGL_NONE
+		};
+		g_surface = eglCreatePbufferSurface(g_display, config, pbuffer_attribs);
+	} else {
+		g_surface = eglCreateWindowSurface(g_display, config, window, NULL);
+	}
 	if (g_surface == EGL_NO_SURFACE) {
 		egl_error();
 	}
@@ -17,16 +17,199 @@
  */
 
 #include "gles.h"
+#include "state.h"
+#include "../option.h"
+#include "../file.h"
 #include <mint.h>
 #include <stdlib.h>
+#include <string.h>
 
-typedef struct gles_obj_t {
-	GLuint data;
-	bee__gles_callback_t destroy;
-} gles_obj_t;
+#define CACHE_MAGIC "BEEP"
+// bump whenever programs are linked differently so older binaries are not reused
+#define CACHE_VERSION "1"
 
-void bee__gles_init() {
-	bee__glext_debug_init();
+typedef struct gles_pool_t {
+	int count;
+	int* free;
+	int free_count;
+	GLuint* dead;
+	int dead_count;
+} gles_pool_t;
+
+typedef struct cache_entry_t {
+	unsigned long long key;
+	GLenum format;
+	int length;
+	const unsigned char* data;
+	_Bool owned;
+	_Bool used;
+} cache_entry_t;
+
+GLuint** bee__gles_slabs[BEE__GLES_TYPES];
+static gles_pool_t g_pools[BEE__GLES_TYPES];
+
+static const char* g_cache_path;
+static unsigned char* g_cache_file;
+static unsigned long long g_cache_driver;
+static cache_entry_t* g_cache;
+static int g_cache_count = 0;
+static _Bool g_cache_dirty = 0;
+
+static unsigned long long cache_hash(unsigned long long hash, const char* str) {
+	// FNV-1a with a terminator so neighbouring strings can not run into each other
+	for (; *str != '\0'; ++str) {
+		hash = (hash ^ (unsigned char)*str) * 0x100000001B3ull;
+	}
+	return (hash ^ 0xFF) * 0x100000001B3ull;
+}
+
+static unsigned long long cache_read(const unsigned char* data, int size) {
+	unsigned long long value = 0;
+	for (int i = size - 1; i >= 0; --i) {
+		value = value << 8 | data[i];
+	}
+	return value;
+}
+
+static void cache_write(unsigned char* data, unsigned long long value, int size) {
+	for (int i = 0; i < size; ++i) {
+		data[i] = value >> (i * 8);
+	}
+}
+
+static void cache_destroy(void* data) {
+	// only programs linked this run are written back so stale binaries drop out
+	if (g_cache_dirty) {
+		int length = 4;
+		for (int i = 0; i < g_cache_count; ++i) {
+			if (g_cache[i].used) {
+				length += 16 + g_cache[i].length;
+			}
+		}
+
+		unsigned char* file = malloc(length);
+		unsigned char* out = file + 4;
+		memcpy(file, CACHE_MAGIC, 4);
+		for (int i = 0; i < g_cache_count; ++i) {
+			cache_entry_t* entry = &g_cache[i];
+			if (entry->used) {
+				cache_write(out, entry->key, 8);
+				cache_write(out + 8, entry->format, 4);
+				cache_write(out + 12, entry->length, 4);
+				memcpy(out + 16, entry->data, entry->length);
+				out += 16 + entry->length;
+			}
+		}
+		if (!bee__file_replace(g_cache_path, file, length)) {
+			mint_warn("GLES: Failed to write '%s'", g_cache_path);
+		}
+		free(file);
+	}
+
+	for (int i = 0; i < g_cache_count; ++i) {
+		if (g_cache[i].owned) {
+			free((void*)g_cache[i].data);
+		}
+	}
+	free(g_cache_file);
+}
+
+static void cache_init() {
+	g_cache_path = bee__option_get("shaders");
+	if (g_cache_path == NULL) {
+		g_cache_path = "8bee.shd";
+	}
+	g_cache_driver = cache_hash(0xCBF29CE484222325ull, CACHE_VERSION);
+	g_cache_driver = cache_hash(g_cache_driver, (char*)glGetString(GL_VENDOR));
+	g_cache_driver = cache_hash(g_cache_driver, (char*)glGetString(GL_RENDERER));
+	g_cache_driver = cache_hash(g_cache_driver, (char*)glGetString(GL_VERSION));
+
+	// entries point into a copy so the file is not left mapped, windows can not replace it otherwise
+	bee__file_t* file = bee__file_map(g_cache_path);
+	int file_length = 0;
+	if (file != NULL) {
+		file_length = file->length;
+		if (file_length > 0) {
+			g_cache_file = malloc(file_length);
+			memcpy(g_cache_file, file->data, file_length);
+		}
+		mint_destroy(file);
+	}
+	if (file_length >= 4 && memcmp(g_cache_file, CACHE_MAGIC, 4) == 0) {
+		int offset = 4;
+		while (offset + 16 <= file_length) {
+			const unsigned char* data = g_cache_file + offset;
+			// anything that does not fit is damage, the rest of the file is ignored
+			unsigned long long length = cache_read(data + 12, 4);
+			if (length > (unsigned long long)(file_length - offset - 16)) {
+				break;
+			}
+			mint_array_check(g_cache, g_cache_count + 1);
+			g_cache[g_cache_count++] = (cache_entry_t){
+				.key = cache_read(data, 8),
+				.format = cache_read(data + 8, 4),
+				.length = length,
+				.data = data + 16
+			};
+			offset += 16 + length;
+		}
+	}
+	mint_create(&g_cache, cache_destroy);
+}
+
+static cache_entry_t* cache_find(unsigned long long key) {
+	for (int i = 0; i < g_cache_count; ++i) {
+		if (g_cache[i].key == key) {
+			return &g_cache[i];
+		}
+	}
+	return NULL;
+}
+
+static _Bool cache_load(GLuint program, unsigned long long key) {
+	cache_entry_t* entry = cache_find(key);
+	if (entry == NULL) {
+		return 0;
+	}
+
+	GLint status;
+	glProgramBinary(program, entry->format, entry->data, entry->length);
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!status) {
+		mint_info("GLES: Cached program rejected by the driver");
+		return 0;
+	}
+	entry->used = 1;
+	return 1;
+}
+
+static void cache_store(GLuint program, unsigned long long key) {
+	GLint length;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+
+	cache_entry_t* entry = cache_find(key);
+	if (entry == NULL) {
+		mint_array_check(g_cache, g_cache_count + 1);
+		entry = &g_cache[g_cache_count++];
+	} else if (entry->owned) {
+		free((void*)entry->data);
+	}
+
+	unsigned char* data = malloc(length);
+	GLenum format;
+	glGetProgramBinary(program, length, &length, &format, data);
+	*entry = (cache_entry_t){
+		.key = key,
+		.format = format,
+		.length = length,
+		.data = data,
+		.owned = 1,
+		.used = 1
+	};
+	g_cache_dirty = 1;
 }
 
 _Bool bee__gles_check_extension(const char* name) {
@@ -46,18 +229,93 @@ _Bool bee__gles_check_extension(const char* name) {
 	return 0;
 }
 
+static void gles_delete(bee__gles_type_t type, GLsizei count, GLuint* names) {
+	switch (type) {
+	case BEE__GLES_TEXTURE:
+		for (int i = 0; i < count; ++i) {
+			bee__state_forget_texture(names[i]);
+		}
+		glDeleteTextures(count, names);
+		break;
+	case BEE__GLES_BUFFER:
+		glDeleteBuffers(count, names);
+		break;
+	case BEE__GLES_FRAMEBUFFER:
+		glDeleteFramebuffers(count, names);
+		break;
+	case BEE__GLES_SHADER:
+		for (int i = 0; i < count; ++i) {
+			glDeleteShader(names[i]);
+		}
+		break;
+	case BEE__GLES_PROGRAM:
+		for (int i = 0; i < count; ++i) {
+			glDeleteProgram(names[i]);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
 static void gles_destroy(void* data) {
-	gles_obj_t* obj = data;
-	obj->destroy(obj->data);
-	free(obj);
+	bee__gles_collect();
+	for (int type = 0; type < BEE__GLES_TYPES; ++type) {
+		gles_pool_t* pool = &g_pools[type];
+		GLuint** slabs = bee__gles_slabs[type];
+		// freed slots are zero and deleting zero is ignored
+		for (int i = 0; i < pool->count; i += BEE__GLES_SLAB) {
+			int count = pool->count - i < BEE__GLES_SLAB ? pool->count - i : BEE__GLES_SLAB;
+			gles_delete(type, count, slabs[i / BEE__GLES_SLAB]);
+			free(slabs[i / BEE__GLES_SLAB]);
+		}
+	}
 }
 
-GLuint* bee__gles_create(GLuint data, bee__gles_callback_t destroy) {
-	gles_obj_t* obj = malloc(sizeof(gles_obj_t));
-	obj->data = data;
-	obj->destroy = destroy;
-	mint_create(obj, gles_destroy);
-	return (GLuint*)obj;
+bee__gles_handle_t bee__gles_create(bee__gles_type_t type, GLuint name) {
+	gles_pool_t* pool = &g_pools[type];
+	int index;
+	if (pool->free_count > 0) {
+		index = pool->free[--pool->free_count];
+	} else {
+		index = pool->count++;
+		if (index % BEE__GLES_SLAB == 0) {
+			mint_array_check(bee__gles_slabs[type], index / BEE__GLES_SLAB + 1);
+			bee__gles_slabs[type][index / BEE__GLES_SLAB] = malloc(BEE__GLES_SLAB * sizeof(GLuint));
+		}
+	}
+	bee__gles_slabs[type][index / BEE__GLES_SLAB][index % BEE__GLES_SLAB] = name;
+	return (bee__gles_handle_t)type << 24 | index;
+}
+
+void bee__gles_destroy(bee__gles_handle_t handle) {
+	gles_pool_t* pool = &g_pools[handle >> 24];
+	int index = handle & 0xFFFFFF;
+	GLuint* slot = &bee__gles_slabs[handle >> 24][index / BEE__GLES_SLAB][index % BEE__GLES_SLAB];
+	mint_array_check(pool->dead, pool->dead_count + 1);
+	pool->dead[pool->dead_count++] = *slot;
+	*slot = 0;
+	mint_array_check(pool->free, pool->free_count + 1);
+	pool->free[pool->free_count++] = index;
+}
+
+void bee__gles_collect() {
+	for (int type = 0; type < BEE__GLES_TYPES; ++type) {
+		gles_pool_t* pool = &g_pools[type];
+		if (pool->dead_count > 0) {
+			gles_delete(type, pool->dead_count, pool->dead);
+			pool->dead_count = 0;
+		}
+	}
+}
+
+void bee__gles_init() {
+	bee__glext_debug_init();
+	bee__glext_binary_init();
+	mint_create(g_pools, gles_destroy);
+	if (GL_binary) {
+		cache_init();
+	}
 }
 
 static void shader_check_error(GLuint object, GLenum STATUS, PFNGLGETSHADERIVPROC Getiv, PFNGLGETSHADERINFOLOGPROC GetInfoLog) {
@@ -78,36 +336,40 @@ static void shader_check_error(GLuint object, GLenum STATUS, PFNGLGETSHADERIVPRO
 	}
 }
 
-static void shader_destroy(GLuint data) {
-	glDeleteShader(data);
-}
-
-static void program_destroy(GLuint data) {
-	glDeleteProgram(data);
-}
-
-static GLuint* shader_compile(GLenum type, const char* code) {
-	GLuint* shader = bee__gles_create(glCreateShader(type), shader_destroy);
-	glShaderSource(*shader, 1, &code, NULL);
-	glCompileShader(*shader);
-	shader_check_error(*shader, GL_COMPILE_STATUS, glGetShaderiv, glGetShaderInfoLog);
+static GLuint shader_compile(GLenum type, const char* code) {
+	GLuint shader = glCreateShader(type);
+	glShaderSource(shader, 1, &code, NULL);
+	glCompileShader(shader);
+	shader_check_error(shader, GL_COMPILE_STATUS, glGetShaderiv, glGetShaderInfoLog);
 	return shader;
 }
 
 GLuint bee__gles_shader(const char* vert, const char* frag) {
-	GLuint* vertex = shader_compile(GL_VERTEX_SHADER, vert);
-	GLuint* fragment = shader_compile(GL_FRAGMENT_SHADER, frag);
 	GLuint program = glCreateProgram();
-	bee__gles_create(program, program_destroy);
+	bee__gles_create(BEE__GLES_PROGRAM, program);
+	unsigned long long key = 0;
+	if (GL_binary) {
+		key = cache_hash(cache_hash(g_cache_driver, vert), frag);
+		if (cache_load(program, key)) {
+			return program;
+		}
+	}
 
-	glAttachShader(program, *vertex);
-	glAttachShader(program, *fragment);
+	bee__gles_handle_t vertex = bee__gles_create(BEE__GLES_SHADER, shader_compile(GL_VERTEX_SHADER, vert));
+	bee__gles_handle_t fragment = bee__gles_create(BEE__GLES_SHADER, shader_compile(GL_FRAGMENT_SHADER, frag));
+	glAttachShader(program, bee__gles_name(vertex));
+	glAttachShader(program, bee__gles_name(fragment));
+	glBindAttribLocation(program, BEE__GLES_POS, "pos");
+	glBindAttribLocation(program, BEE__GLES_COORD, "coord");
 	glLinkProgram(program);
 	shader_check_error(program, GL_LINK_STATUS, glGetProgramiv, glGetProgramInfoLog);
 
-	glDetachShader(program, *vertex);
-	glDetachShader(program, *fragment);
-	mint_destroy(vertex);
-	mint_destroy(fragment);
+	glDetachShader(program, bee__gles_name(vertex));
+	glDetachShader(program, bee__gles_name(fragment));
+	bee__gles_destroy(vertex);
+	bee__gles_destroy(fragment);
+	if (GL_binary) {
+		cache_store(program, key);
+	}
 	return program;
 }
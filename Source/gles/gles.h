@@ -21,12 +21,40 @@
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 #include "glext/debug.h"
+#include "glext/binary.h"
 
-typedef void (*bee__gles_callback_t)(GLuint data);
+// attribute locations every program is linked with so they can share vertex state
+#define BEE__GLES_POS 0
+#define BEE__GLES_COORD 1
+
+// names are kept in fixed size slabs so a handle stays valid until it is destroyed
+#define BEE__GLES_SLAB 64
+
+typedef enum bee__gles_type_t {
+	BEE__GLES_TEXTURE,
+	BEE__GLES_BUFFER,
+	BEE__GLES_FRAMEBUFFER,
+	BEE__GLES_SHADER,
+	BEE__GLES_PROGRAM,
+	BEE__GLES_TYPES
+} bee__gles_type_t;
+
+// the type sits in the top byte and the slot index below it
+typedef unsigned bee__gles_handle_t;
+
+extern GLuint** bee__gles_slabs[BEE__GLES_TYPES];
 
 void bee__gles_init();
 _Bool bee__gles_check_extension(const char* name);
-GLuint* bee__gles_create(GLuint data, bee__gles_callback_t destroy);
+bee__gles_handle_t bee__gles_create(bee__gles_type_t type, GLuint name);
+// names are only deleted by the next collect, a batch at a time for each type
+void bee__gles_destroy(bee__gles_handle_t handle);
+void bee__gles_collect();
 GLuint bee__gles_shader(const char* vert, const char* frag);
 
+static inline GLuint bee__gles_name(bee__gles_handle_t handle) {
+	unsigned index = handle & 0xFFFFFF;
+	return bee__gles_slabs[handle >> 24][index / BEE__GLES_SLAB][index % BEE__GLES_SLAB];
+}
+
 #endif
@@ -0,0 +1,40 @@
+/*
+ * binary.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "binary.h"
+#include <mint.h>
+#include <EGL/egl.h>
+
+_Bool bee__GL_binary = 0;
+PFNGLGETPROGRAMBINARYOESPROC bee__glGetProgramBinary;
+PFNGLPROGRAMBINARYOESPROC bee__glProgramBinary;
+
+void bee__glext_binary_init() {
+	// drivers can have the extension without any formats to save in
+	GLint formats = 0;
+	if (bee__gles_check_extension("GL_OES_get_program_binary")) {
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	}
+	if (formats > 0) {
+		bee__GL_binary = 1;
+		bee__glGetProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+		bee__glProgramBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+	} else {
+		mint_warn("GLES: GL_binary unsupported");
+	}
+}
@@ -0,0 +1,35 @@
+/*
+ * binary.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLEXT_BINARY_H_
+#define GLEXT_BINARY_H_
+#include "../gles.h"
+
+extern _Bool bee__GL_binary;
+extern PFNGLGETPROGRAMBINARYOESPROC bee__glGetProgramBinary;
+extern PFNGLPROGRAMBINARYOESPROC bee__glProgramBinary;
+
+#define GL_binary bee__GL_binary
+#define GL_PROGRAM_BINARY_LENGTH GL_PROGRAM_BINARY_LENGTH_OES
+#define GL_NUM_PROGRAM_BINARY_FORMATS GL_NUM_PROGRAM_BINARY_FORMATS_OES
+#define glGetProgramBinary bee__glGetProgramBinary
+#define glProgramBinary bee__glProgramBinary
+
+void bee__glext_binary_init();
+
+#endif
@@ -0,0 +1,7 @@
+attribute vec2 pos;
+varying vec2 texcoord;
+
+void main() {
+	texcoord = pos * 0.5 + 0.5;
+	gl_Position = vec4(pos, 0, 1);
+}
\ No newline at end of file
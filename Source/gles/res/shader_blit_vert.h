@@ -0,0 +1 @@
+static const char bee__res_shader_blit_vert[]={97,116,116,114,105,98,117,116,101,32,118,101,99,50,32,112,111,115,59,13,10,118,97,114,121,105,110,103,32,118,101,99,50,32,116,101,120,99,111,111,114,100,59,13,10,13,10,118,111,105,100,32,109,97,105,110,40,41,32,123,13,10,9,116,101,120,99,111,111,114,100,32,61,32,112,111,115,32,42,32,48,46,53,32,43,32,48,46,53,59,13,10,9,103,108,95,80,111,115,105,116,105,111,110,32,61,32,118,101,99,52,40,112,111,115,44,32,48,44,32,49,41,59,13,10,125,0};
\ No newline at end of file
@@ -0,0 +1,10 @@
+precision mediump float;
+varying vec2 texcoord;
+uniform sampler2D texture;
+uniform sampler2D palette;
+
+void main() {
+	// indices come back as index / 255, the palette is 256 texels across
+	float index = texture2D(texture, texcoord).r;
+	gl_FragColor = texture2D(palette, vec2(index * (255.0 / 256.0) + (0.5 / 256.0), 0.5));
+}
\ No newline at end of file
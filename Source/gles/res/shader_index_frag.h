@@ -0,0 +1 @@
+static const char bee__res_shader_index_frag[]={112,114,101,99,105,115,105,111,110,32,109,101,100,105,117,109,112,32,102,108,111,97,116,59,13,10,118,97,114,121,105,110,103,32,118,101,99,50,32,116,101,120,99,111,111,114,100,59,13,10,117,110,105,102,111,114,109,32,115,97,109,112,108,101,114,50,68,32,116,101,120,116,117,114,101,59,13,10,117,110,105,102,111,114,109,32,115,97,109,112,108,101,114,50,68,32,112,97,108,101,116,116,101,59,13,10,13,10,118,111,105,100,32,109,97,105,110,40,41,32,123,13,10,9,47,47,32,105,110,100,105,99,101,115,32,99,111,109,101,32,98,97,99,107,32,97,115,32,105,110,100,101,120,32,47,32,50,53,53,44,32,116,104,101,32,112,97,108,101,116,116,101,32,105,115,32,50,53,54,32,116,101,120,101,108,115,32,97,99,114,111,115,115,13,10,9,102,108,111,97,116,32,105,110,100,101,120,32,61,32,116,101,120,116,117,114,101,50,68,40,116,101,120,116,117,114,101,44,32,116,101,120,99,111,111,114,100,41,46,114,59,13,10,9,103,108,95,70,114,97,103,67,111,108,111,114,32,61,32,116,101,120,116,117,114,101,50,68,40,112,97,108,101,116,116,101,44,32,118,101,99,50,40,105,110,100,101,120,32,42,32,40,50,53,53,46,48,32,47,32,50,53,54,46,48,41,32,43,32,40,48,46,53,32,47,32,50,53,54,46,48,41,44,32,48,46,53,41,41,59,13,10,125,0};
\ No newline at end of file
@@ -1 +1 @@
-static const char bee__res_shader_main_vert[]={97,116,116,114,105,98,117,116,101,32,118,101,99,50,32,112,111,115,59,13,10,97,116,116,114,105,98,117,116,101,32,118,101,99,51,32,109,97,116,48,59,13,10,97,116,116,114,105,98,117,116,101,32,118,101,99,51,32,109,97,116,49,59,13,10,97,116,116,114,105,98,117,116,101,32,118,101,99,52,32,115,112,114,105,116,101,59,13,10,118,97,114,121,105,110,103,32,118,101,99,50,32,116,101,120,99,111,111,114,100,59,13,10,13,10,118,111,105,100,32,109,97,105,110,40,41,32,123,13,10,9,105,102,32,40,112,111,115,46,120,32,60,32,48,46,48,41,32,123,13,10,9,9,116,101,120,99,111,111,114,100,46,120,32,61,32,115,112,114,105,116,101,46,120,59,13,10,9,125,32,101,108,115,101,32,123,13,10,9,9,116,101,120,99,111,111,114,100,46,120,32,61,32,115,112,114,105,116,101,46,122,59,13,10,9,125,13,10,9,105,102,32,40,112,111,115,46,121,32,60,32,48,46,48,41,32,123,13,10,9,9,116,101,120,99,111,111,114,100,46,121,32,61,32,115,112,114,105,116,101,46,121,59,13,10,9,125,32,101,108,115,101,32,123,13,10,9,9,116,101,120,99,111,111,114,100,46,121,32,61,32,115,112,114,105,116,101,46,119,59,13,10,9,125,13,10,13,10,9,103,108,95,80,111,115,105,116,105,111,110,32,61,32,118,101,99,52,40,40,109,97,116,51,40,13,10,9,9,9,109,97,116,48,46,120,44,32,109,97,116,49,46,120,44,32,48,44,13,10,9,9,9,109,97,116,48,46,121,44,32,109,97,116,49,46,121,44,32,48,44,13,10,9,9,9,109,97,116,48,46,122,44,32,109,97,116,49,46,122,44,32,49,13,10,9,41,32,42,32,118,101,99,51,40,112,111,115,44,32,49,41,41,46,120,121,44,32,48,44,32,49,41,59,13,10,125,0};
\ No newline at end of file
+static const char bee__res_shader_main_vert[]={97,116,116,114,105,98,117,116,101,32,118,101,99,50,32,112,111,115,59,13,10,97,116,116,114,105,98,117,116,101,32,118,101,99,50,32,99,111,111,114,100,59,13,10,118,97,114,121,105,110,103,32,118,101,99,50,32,116,101,120,99,111,111,114,100,59,13,10,13,10,118,111,105,100,32,109,97,105,110,40,41,32,123,13,10,9,116,101,120,99,111,111,114,100,32,61,32,99,111,111,114,100,59,13,10,9,103,108,95,80,111,115,105,116,105,111,110,32,61,32,118,101,99,52,40,112,111,115,32,47,32,49,48,50,52,46,48,44,32,48,44,32,49,41,59,13,10,125,0};
\ No newline at end of file
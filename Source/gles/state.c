@@ -0,0 +1,127 @@
+/*
+ * state.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "state.h"
+
+// nothing is known about the context until the first call sets it
+#define STATE_UNKNOWN ((GLuint)-1)
+
+static GLuint g_texture = STATE_UNKNOWN;
+static GLuint g_framebuffer = STATE_UNKNOWN;
+static GLuint g_attachment = STATE_UNKNOWN;
+static GLsizei g_viewport[2] = {-1, -1};
+static GLuint g_program = STATE_UNKNOWN;
+static GLuint g_array_buffer = STATE_UNKNOWN;
+static GLuint g_element_buffer = STATE_UNKNOWN;
+static unsigned g_attribs = 0;
+static unsigned g_attribs_known = 0;
+
+static _Bool state_set(GLuint* shadow, GLuint value) {
+	if (*shadow == value) {
+		return 0;
+	}
+	*shadow = value;
+	return 1;
+}
+
+_Bool bee__state_texture(GLuint name) {
+	if (!state_set(&g_texture, name)) {
+		return 0;
+	}
+	glBindTexture(GL_TEXTURE_2D, name);
+	return 1;
+}
+
+_Bool bee__state_framebuffer(GLuint name) {
+	if (!state_set(&g_framebuffer, name)) {
+		return 0;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, name);
+	return 1;
+}
+
+_Bool bee__state_attachment(GLuint texture) {
+	// only one framebuffer is ever created so its attachment is the only one to track
+	if (!state_set(&g_attachment, texture)) {
+		return 0;
+	}
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+	return 1;
+}
+
+_Bool bee__state_viewport(GLsizei width, GLsizei height) {
+	if (g_viewport[0] == width && g_viewport[1] == height) {
+		return 0;
+	}
+	g_viewport[0] = width;
+	g_viewport[1] = height;
+	glViewport(0, 0, width, height);
+	return 1;
+}
+
+_Bool bee__state_program(GLuint program) {
+	if (!state_set(&g_program, program)) {
+		return 0;
+	}
+	glUseProgram(program);
+	return 1;
+}
+
+_Bool bee__state_buffer(GLenum target, GLuint buffer) {
+	GLuint* shadow = target == GL_ARRAY_BUFFER ? &g_array_buffer : &g_element_buffer;
+	if (!state_set(shadow, buffer)) {
+		return 0;
+	}
+	glBindBuffer(target, buffer);
+	return 1;
+}
+
+_Bool bee__state_attrib(GLuint index, _Bool enabled) {
+	unsigned bit = 1u << index;
+	if ((g_attribs_known & bit) && !(g_attribs & bit) == !enabled) {
+		return 0;
+	}
+
+	g_attribs_known |= bit;
+	if (enabled) {
+		g_attribs |= bit;
+		glEnableVertexAttribArray(index);
+	} else {
+		g_attribs &= ~bit;
+		glDisableVertexAttribArray(index);
+	}
+	return 1;
+}
+
+void bee__state_forget_texture(GLuint name) {
+	// deleting unbinds it, but another framebuffer could still hold the old attachment
+	if (g_texture == name) {
+		g_texture = 0;
+	}
+	if (g_attachment == name) {
+		g_attachment = STATE_UNKNOWN;
+	}
+}
+
+GLuint bee__state_bound_texture() {
+	return g_texture;
+}
+
+GLuint bee__state_bound_program() {
+	return g_program;
+}
@@ -0,0 +1,38 @@
+/*
+ * state.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLES_STATE_H_
+#define GLES_STATE_H_
+#include "gles.h"
+
+// shadows the bindings the renderer touches and drops calls that would not change them,
+// each returns whether the call reached the driver, textures are only tracked on the first unit
+_Bool bee__state_texture(GLuint name);
+_Bool bee__state_framebuffer(GLuint name);
+_Bool bee__state_attachment(GLuint texture);
+_Bool bee__state_viewport(GLsizei width, GLsizei height);
+_Bool bee__state_program(GLuint program);
+_Bool bee__state_buffer(GLenum target, GLuint buffer);
+_Bool bee__state_attrib(GLuint index, _Bool enabled);
+// must be called before a texture is deleted so a reused name is not mistaken for it
+void bee__state_forget_texture(GLuint name);
+
+GLuint bee__state_bound_texture();
+GLuint bee__state_bound_program();
+
+#endif
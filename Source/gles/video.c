@@ -19,33 +19,63 @@
 #include "../video.h"
 #include "gles.h"
 #include "context.h"
+#include "state.h"
+#include "../window.h"
+#include "../profile.h"
 #include <mint.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "res/shader_main_vert.h"
 #include "res/shader_main_frag.h"
+#include "res/shader_blit_vert.h"
+#include "res/shader_index_frag.h"
 
-#define BUFFER_SIZE 16
+// the largest batch that can be addressed with 16-bit indices
+#define BATCH_MAX (0x10000 / 4)
+
+// positions are stored in 1/16th of a pixel, converted from 16.16 canvas pixels
+#define POS_SHIFT 12
+
+typedef struct vertex_t {
+	GLshort x, y;
+	GLubyte s, t;
+	GLubyte padding[2];
+} vertex_t;
 
 typedef struct elem_t {
-	bee__matrix_t matrix;
-	struct {
-		GLubyte x0, y0, x1, y1;
-	} sprite;
+	vertex_t vertices[4];
 } elem_t;
 
+typedef struct texture_t {
+	bee__gles_handle_t name;
+	GLsizei width;
+	GLsizei height;
+	_Bool indexed;
+} texture_t;
+
 static GLuint g_shader;
-static GLint g_shader_pos;
-static GLint g_shader_mat0;
-static GLint g_shader_mat1;
-static GLint g_shader_sprite;
+static GLuint g_index_shader;
+static GLuint g_blit_shader;
+static bee__gles_handle_t g_palette;
 
-static const GLuint g_quad = 1;
+static const GLuint g_vertex_buffer = 1;
+static const GLuint g_index_buffer = 2;
+static const GLuint g_blit_buffer = 3;
 static const GLuint g_framebuffer = 1;
 
-static elem_t g_buffer_data[BUFFER_SIZE];
+static elem_t* g_buffer_data;
 static int g_buffer_count = 0;
+static GLushort* g_index_data;
+static int g_index_count = 0;
 
+static GLuint g_current_shader = 0;
 static GLuint g_current_texture = 0;
+static texture_t* g_current_target = NULL;
+static GLubyte* g_read_data;
+static GLushort* g_map_data;
+static GLubyte* g_index_map_data;
 
 static void GL_APIENTRY gles_error(GLenum source, GLenum type, GLuint id, GLenum severity,
 		GLsizei length, const GLchar* message, const void* data) {
@@ -76,38 +106,100 @@ static void GL_APIENTRY gles_error(GLenum source, GLenum type, GLuint id, GLenum
 	}
 }
 
-static void buffer_destroy(GLuint data) {
-	glDeleteBuffers(1, &data);
+static void texture_free(void* data) {
+	texture_t* texture = data;
+	bee__gles_destroy(texture->name);
+	free(texture);
+}
+
+static GLshort video_pos(int64_t value) {
+	value = (value + (1 << (POS_SHIFT - 1))) >> POS_SHIFT;
+	if (value > 0x7FFF) {
+		return 0x7FFF;
+	} else if (value < -0x7FFF) {
+		return -0x7FFF;
+	}
+	return value;
+}
+
+static void video_indices(int count) {
+	if (count > BATCH_MAX) {
+		count = BATCH_MAX;
+	}
+	if (count > g_index_count) {
+		mint_array_check(g_index_data, count * 6);
+		for (int i = g_index_count; i < count; ++i) {
+			GLushort* index = g_index_data + i * 6;
+			GLushort vertex = i * 4;
+			index[0] = vertex + 0;
+			index[1] = vertex + 1;
+			index[2] = vertex + 2;
+			index[3] = vertex + 3;
+			index[4] = vertex + 2;
+			index[5] = vertex + 1;
+		}
+		g_index_count = count;
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * 6 * sizeof(GLushort), g_index_data, GL_STATIC_DRAW);
+	}
 }
 
-static void framebuffer_destroy(GLuint data) {
-	glDeleteFramebuffers(1, &data);
+// only calls that reached the driver every time before bindings were shadowed count as redundant,
+// the batch state a flush puts back would otherwise be counted against itself
+static void video_redundant(_Bool issued) {
+	if (!issued) {
+		bee__profile_count(BEE__PROFILE_REDUNDANT, 1);
+	}
 }
 
-static void texture_destroy(GLuint data) {
-	glDeleteTextures(1, &data);
+static void video_target(texture_t* texture, _Bool count) {
+	int dropped = 0;
+	if (texture == NULL) {
+		dropped += !bee__state_framebuffer(0);
+		dropped += !bee__state_viewport(BEE__WINDOW_SIZE, BEE__WINDOW_SIZE);
+	} else {
+		dropped += !bee__state_framebuffer(g_framebuffer);
+		dropped += !bee__state_attachment(bee__gles_name(texture->name));
+		dropped += !bee__state_viewport(texture->width, texture->height);
+	}
+	if (count) {
+		bee__profile_count(BEE__PROFILE_REDUNDANT, dropped);
+	}
 }
 
 static void video_flush() {
 	if (g_buffer_count > 0) {
-		for (int i = 0; i < g_buffer_count; ++i) {
-			elem_t* elem = g_buffer_data + i;
-			glVertexAttrib3fv(glGetAttribLocation(g_shader, "mat0"), &elem->matrix.m00);
-			glVertexAttrib3fv(glGetAttribLocation(g_shader, "mat1"), &elem->matrix.m10);
-			glVertexAttrib4f(glGetAttribLocation(g_shader, "sprite"),
-					elem->sprite.x0 / 255.0,
-					elem->sprite.y0 / 255.0,
-					elem->sprite.x1 / 255.0,
-					elem->sprite.y1 / 255.0
-			);
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+		long long begin = bee__profile_begin();
+		// other calls are free to leave their own bindings, the batch state is put back here
+		video_target(g_current_target, 0);
+		bee__state_program(g_current_shader);
+		long long bind = bee__profile_begin();
+		bee__state_texture(g_current_texture);
+		bee__profile_end(BEE__PROFILE_BIND, bind);
+		bee__state_buffer(GL_ARRAY_BUFFER, g_vertex_buffer);
+		bee__state_attrib(BEE__GLES_COORD, 1);
+
+		video_indices(g_buffer_count);
+		glBufferData(GL_ARRAY_BUFFER, g_buffer_count * sizeof(elem_t), g_buffer_data, GL_STREAM_DRAW);
+		for (int i = 0; i < g_buffer_count; i += BATCH_MAX) {
+			int count = g_buffer_count - i;
+			if (count > BATCH_MAX) {
+				count = BATCH_MAX;
+			}
+
+			char* offset = (char*)NULL + i * sizeof(elem_t);
+			glVertexAttribPointer(BEE__GLES_POS, 2, GL_SHORT, GL_FALSE, sizeof(vertex_t), offset + offsetof(vertex_t, x));
+			glVertexAttribPointer(BEE__GLES_COORD, 2, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(vertex_t), offset + offsetof(vertex_t, s));
+			glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_SHORT, NULL);
+			bee__profile_count(BEE__PROFILE_DRAWS, 1);
 		}
 		g_buffer_count = 0;
+		bee__profile_count(BEE__PROFILE_FLUSHES, 1);
+		bee__profile_end(BEE__PROFILE_FLUSH, begin);
 	}
 }
 
 void bee__video_init_native(void* window) {
-	bee__context_init(window);
+	bee__context_init((EGLNativeWindowType)window);
 	bee__gles_init();
 	if (GL_debug) {
 		glEnable(GL_DEBUG_OUTPUT);
@@ -115,92 +207,211 @@ void bee__video_init_native(void* window) {
 	}
 	mint_info("GLES: %s", (char*)glGetString(GL_RENDERER));
 
-	static const GLfloat quad_data[] = {
-			-0.5, -0.5,
-			 0.5, -0.5,
-			-0.5,  0.5,
-			 0.5,  0.5,
-			-0.5,  0.5,
-			 0.5, -0.5
-	};
-
 	g_shader = bee__gles_shader(bee__res_shader_main_vert, bee__res_shader_main_frag);
-	g_shader_pos = glGetAttribLocation(g_shader, "pos");
-	g_shader_mat0 = glGetAttribLocation(g_shader, "mat0");
-	g_shader_mat1 = glGetAttribLocation(g_shader, "mat1");
-	g_shader_sprite = glGetAttribLocation(g_shader, "sprite");
+	g_index_shader = bee__gles_shader(bee__res_shader_main_vert, bee__res_shader_index_frag);
+	bee__state_program(g_index_shader);
+	glUniform1i(glGetUniformLocation(g_index_shader, "palette"), 1);
+	g_current_shader = g_shader;
+
+	// the palette stays bound to the second texture unit
+	GLuint name;
+	glGenTextures(1, &name);
+	g_palette = bee__gles_create(BEE__GLES_TEXTURE, name);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, name);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 1, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glActiveTexture(GL_TEXTURE0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	bee__state_buffer(GL_ARRAY_BUFFER, g_vertex_buffer);
+	bee__gles_create(BEE__GLES_BUFFER, g_vertex_buffer);
+	bee__state_buffer(GL_ELEMENT_ARRAY_BUFFER, g_index_buffer);
+	bee__gles_create(BEE__GLES_BUFFER, g_index_buffer);
+	bee__state_attrib(BEE__GLES_POS, 1);
+	bee__state_attrib(BEE__GLES_COORD, 1);
 
-	glBindBuffer(GL_ARRAY_BUFFER, g_quad);
-	bee__gles_create(g_quad, buffer_destroy);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(quad_data), quad_data, GL_STATIC_DRAW);
-	glEnableVertexAttribArray(g_shader_pos);
-	glVertexAttribPointer(g_shader_pos, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	bee__gles_create(BEE__GLES_FRAMEBUFFER, g_framebuffer);
 
-	bee__gles_create(g_framebuffer, framebuffer_destroy);
+	// presenting draws one triangle that covers the window
+	static const GLbyte blit[] = {-1, -1, 3, -1, -1, 3};
+	g_blit_shader = bee__gles_shader(bee__res_shader_blit_vert, bee__res_shader_main_frag);
+	bee__state_buffer(GL_ARRAY_BUFFER, g_blit_buffer);
+	bee__gles_create(BEE__GLES_BUFFER, g_blit_buffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(blit), blit, GL_STATIC_DRAW);
 }
 
-void bee__video_update_native() {
+void bee__video_present_native(void* texture) {
 	video_flush();
+	texture_t* src = texture;
+	video_redundant(bee__state_framebuffer(0));
+	video_redundant(bee__state_viewport(src->width * (BEE__WINDOW_SIZE / src->width), src->height * (BEE__WINDOW_SIZE / src->height)));
+	video_redundant(bee__state_program(g_blit_shader));
+	video_redundant(bee__state_buffer(GL_ARRAY_BUFFER, g_blit_buffer));
+	video_redundant(bee__state_texture(bee__gles_name(src->name)));
+	video_redundant(bee__state_attrib(BEE__GLES_COORD, 0));
+	glVertexAttribPointer(BEE__GLES_POS, 2, GL_BYTE, GL_FALSE, 0, NULL);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	bee__profile_count(BEE__PROFILE_DRAWS, 1);
 	bee__context_update();
+	// anything destroyed during the frame is deleted together once nothing can draw with it
+	bee__gles_collect();
 }
 
-void bee__video_clear() {
+void bee__video_clear_native() {
 	g_buffer_count = 0;
+	video_target(g_current_target, 0);
 	glClear(GL_COLOR_BUFFER_BIT);
 }
 
-void* bee__video_texture_create(int width, int height, unsigned short* data) {
+void* bee__video_texture_create_native(int width, int height, unsigned short* data) {
 	GLuint name;
 	glGenTextures(1, &name);
-	glBindTexture(GL_TEXTURE_2D, name);
-	GLuint* texture = bee__gles_create(name, texture_destroy);
+	video_redundant(bee__state_texture(name));
+	texture_t* texture = malloc(sizeof(texture_t));
+	texture->name = bee__gles_create(BEE__GLES_TEXTURE, name);
+	texture->width = width;
+	texture->height = height;
+	texture->indexed = 0;
+	mint_create(texture, texture_free);
 
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, data);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glBindTexture(GL_TEXTURE_2D, g_current_texture);
 	return texture;
 }
 
-void bee__video_texture_update(void* texture, const bee_sprite_t* sprite, unsigned short* data) {
-	GLuint name = *(GLuint*)texture;
-	glBindTexture(GL_TEXTURE_2D, name);
+void bee__video_texture_update_native(void* texture, const bee_sprite_t* sprite, unsigned short* data) {
+	video_flush();
+	GLuint name = bee__gles_name(((texture_t*)texture)->name);
+	video_redundant(bee__state_texture(name));
 	glTexSubImage2D(GL_TEXTURE_2D, 0, sprite->x, sprite->y, sprite->w, sprite->h, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, data);
-	glBindTexture(GL_TEXTURE_2D, g_current_texture);
 }
 
-void bee__video_texture_target(void* texture) {
+unsigned short* bee__video_texture_map_native(void* texture) {
+	texture_t* src = texture;
+	mint_array_check(g_map_data, src->width * src->height);
+	return g_map_data;
+}
+
+void bee__video_texture_unmap_native(void* texture) {
+	texture_t* dst = texture;
+	video_redundant(bee__state_texture(bee__gles_name(dst->name)));
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, dst->width, dst->height, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, g_map_data);
+}
+
+void* bee__video_index_create_native(int width, int height) {
+	GLuint name;
+	glGenTextures(1, &name);
+	video_redundant(bee__state_texture(name));
+	texture_t* texture = malloc(sizeof(texture_t));
+	texture->name = bee__gles_create(BEE__GLES_TEXTURE, name);
+	texture->width = width;
+	texture->height = height;
+	texture->indexed = 1;
+	mint_create(texture, texture_free);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, width, height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	return texture;
+}
+
+void bee__video_index_update_native(void* texture, const bee_sprite_t* sprite, unsigned char* data) {
 	video_flush();
-	if (texture == NULL) {
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-	} else {
-		GLuint name = *(GLuint*)texture;
-		glBindFramebuffer(GL_FRAMEBUFFER, g_framebuffer);
-		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, name, 0);
+	GLuint name = bee__gles_name(((texture_t*)texture)->name);
+	video_redundant(bee__state_texture(name));
+	glTexSubImage2D(GL_TEXTURE_2D, 0, sprite->x, sprite->y, sprite->w, sprite->h, GL_LUMINANCE, GL_UNSIGNED_BYTE, data);
+}
+
+unsigned char* bee__video_index_map_native(void* texture) {
+	texture_t* src = texture;
+	mint_array_check(g_index_map_data, src->width * src->height);
+	return g_index_map_data;
+}
+
+void bee__video_index_unmap_native(void* texture) {
+	texture_t* dst = texture;
+	bee_sprite_t all = {0, 0, dst->width, dst->height};
+	bee__video_index_update_native(texture, &all, g_index_map_data);
+}
+
+void bee__video_palette_native(int index, int count, const unsigned short* colors) {
+	// queued draws still look up the old colours
+	video_flush();
+	glActiveTexture(GL_TEXTURE1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, index, 0, count, 1, GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, colors);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void bee__video_texture_read(void* texture, const bee_sprite_t* sprite, unsigned short* data) {
+	video_flush();
+	video_target(texture, 1);
+
+	// RGBA bytes are the only read format every implementation supports
+	int length = sprite->w * sprite->h;
+	mint_array_check(g_read_data, length * 4);
+	glReadPixels(sprite->x, sprite->y, sprite->w, sprite->h, GL_RGBA, GL_UNSIGNED_BYTE, g_read_data);
+	for (int i = 0; i < length; ++i) {
+		GLubyte* pixel = g_read_data + i * 4;
+		data[i] = ((pixel[0] >> 4) << 12) | ((pixel[1] >> 4) << 8) | ((pixel[2] >> 4) << 4) | (pixel[3] >> 4);
 	}
 }
 
-void bee__video_texture_draw(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix) {
-	GLuint name = *(GLuint*)texture;
+void bee__video_texture_target_native(void* texture) {
+	video_flush();
+	long long begin = bee__profile_begin();
+	g_current_target = texture;
+	video_target(g_current_target, 1);
+	bee__profile_count(BEE__PROFILE_TARGETS, 1);
+	bee__profile_end(BEE__PROFILE_TARGET, begin);
+}
+
+void bee__video_texture_draw_native(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix) {
+	GLuint shader = ((texture_t*)texture)->indexed ? g_index_shader : g_shader;
+	if (shader != g_current_shader) {
+		video_flush();
+		g_current_shader = shader;
+	}
+
+	GLuint name = bee__gles_name(((texture_t*)texture)->name);
 	if (name != g_current_texture) {
 		video_flush();
-		glBindTexture(GL_TEXTURE_2D, name);
 		g_current_texture = name;
+		bee__profile_count(BEE__PROFILE_BINDS, 1);
 	}
 
-	elem_t* elem = g_buffer_data + g_buffer_count;
-	elem->matrix = *matrix;
-	elem->matrix.m00 *= sprite->w;
-	elem->matrix.m01 *= sprite->h;
-	elem->matrix.m10 *= sprite->w;
-	elem->matrix.m11 *= sprite->h;
-
-	elem->sprite.x0 = sprite->x * 2;
-	elem->sprite.y0 = sprite->y * 2;
-	elem->sprite.x1 = (sprite->x + sprite->w - 1) * 2;
-	elem->sprite.y1 = (sprite->y + sprite->h - 1) * 2;
-	++g_buffer_count;
-	if (g_buffer_count == BUFFER_SIZE) {
-		video_flush();
+	mint_array_check(g_buffer_data, g_buffer_count + 1);
+	elem_t* elem = g_buffer_data + g_buffer_count++;
+
+	int64_t ax = (int64_t)matrix->m00 * sprite->w / 2;
+	int64_t ay = (int64_t)matrix->m10 * sprite->w / 2;
+	int64_t bx = (int64_t)matrix->m01 * sprite->h / 2;
+	int64_t by = (int64_t)matrix->m11 * sprite->h / 2;
+	for (int i = 0; i < 4; ++i) {
+		vertex_t* vertex = elem->vertices + i;
+		int64_t x = matrix->m02;
+		int64_t y = matrix->m12;
+		if (i & 1) {
+			x += ax;
+			y += ay;
+			vertex->s = (sprite->x + sprite->w - 1) * 2;
+		} else {
+			x -= ax;
+			y -= ay;
+			vertex->s = sprite->x * 2;
+		}
+		if (i & 2) {
+			x += bx;
+			y += by;
+			vertex->t = (sprite->y + sprite->h - 1) * 2;
+		} else {
+			x -= bx;
+			y -= by;
+			vertex->t = sprite->y * 2;
+		}
+		vertex->x = video_pos(x);
+		vertex->y = video_pos(y);
 	}
 }
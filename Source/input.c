@@ -0,0 +1,189 @@
+/*
+ * input.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "input.h"
+#include "clock.h"
+#include "file.h"
+#include "option.h"
+#include <8bee.h>
+#include <mint.h>
+#include <stdio.h>
+#include <string.h>
+
+// events between two ticks, must be a power of two
+#define INPUT_QUEUE 256
+
+// recordings are the magic followed by a varint tick delta and state byte for every change
+#define INPUT_MAGIC "BEEI"
+
+typedef struct event_t {
+	long long time;
+	unsigned char button;
+	_Bool down;
+} event_t;
+
+static event_t g_events[INPUT_QUEUE];
+static unsigned int g_head = 0;
+static unsigned int g_tail = 0;
+
+static unsigned char g_state = 0;
+// what the scene sees, buttons pressed during the tick count even if already released
+static unsigned char g_input = 0;
+static unsigned int g_tick = 0;
+static long long g_latency = 0;
+
+static FILE* g_record;
+static unsigned int g_record_tick = 0;
+static unsigned char g_record_state = 0;
+
+static bee__file_t* g_replay;
+static int g_replay_index;
+static unsigned int g_replay_tick = 0;
+
+static void input_destroy(void* data) {
+	mint_info("INPUT: %u ticks, longest event wait %lli us", g_tick, g_latency / 1000);
+}
+
+static void record_destroy(void* data) {
+	fclose(data);
+}
+
+static void record_write(unsigned char state) {
+	unsigned int delta = g_tick - g_record_tick;
+	while (delta >= 0x80) {
+		fputc((delta & 0x7F) | 0x80, g_record);
+		delta >>= 7;
+	}
+	fputc(delta, g_record);
+	fputc(state, g_record);
+	g_record_tick = g_tick;
+}
+
+// reads the next change into g_replay_tick, returns 0 at the end of the recording
+static _Bool replay_next(unsigned char* state) {
+	const unsigned char* data = g_replay->data;
+	int length = g_replay->length;
+	unsigned int delta = 0;
+	for (int shift = 0; g_replay_index < length; shift += 7) {
+		unsigned char byte = data[g_replay_index++];
+		delta |= (byte & 0x7F) << shift;
+		if (!(byte & 0x80)) {
+			if (g_replay_index >= length) {
+				break;
+			}
+			*state = data[g_replay_index++];
+			g_replay_tick += delta;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void replay_update() {
+	while (g_replay_index < g_replay->length) {
+		int index = g_replay_index;
+		unsigned int tick = g_replay_tick;
+		unsigned char state;
+		if (!replay_next(&state)) {
+			mint_fail("INPUT: Invalid recording");
+		}
+		if (g_replay_tick > g_tick) {
+			g_replay_index = index;
+			g_replay_tick = tick;
+			break;
+		}
+		g_state = state;
+		if (g_replay_index == g_replay->length) {
+			mint_info("INPUT: Replay finished at tick %u", g_tick);
+		}
+	}
+}
+
+void bee__input_init() {
+	mint_create(&g_tick, input_destroy);
+
+	const char* replay = bee__option_get("replay");
+	if (replay != NULL) {
+		g_replay = bee__file_map(replay);
+		if (g_replay == NULL) {
+			mint_fail("INPUT: Failed to open '%s'", replay);
+		}
+		if (g_replay->length < 4 || memcmp(g_replay->data, INPUT_MAGIC, 4) != 0) {
+			mint_fail("INPUT: Invalid recording");
+		}
+		g_replay_index = 4;
+		mint_info("INPUT: Replaying '%s'", replay);
+	}
+
+	const char* record = bee__option_get("record");
+	if (record != NULL) {
+		g_record = fopen(record, "wb");
+		if (g_record == NULL) {
+			mint_fail("INPUT: Failed to open '%s'", record);
+		}
+		mint_create(g_record, record_destroy);
+		fwrite(INPUT_MAGIC, 1, 4, g_record);
+		mint_info("INPUT: Recording to '%s'", record);
+	}
+}
+
+void bee__input_event(int button, _Bool down) {
+	if (g_tail - g_head == INPUT_QUEUE) {
+		mint_warn("INPUT: Event queue full");
+		return;
+	}
+	event_t* event = g_events + g_tail++ % INPUT_QUEUE;
+	event->time = bee__clock_get();
+	event->button = button;
+	event->down = down;
+}
+
+void bee__input_update() {
+	long long now = bee__clock_get();
+	unsigned char pressed = 0;
+	for (; g_head != g_tail; ++g_head) {
+		event_t* event = g_events + g_head % INPUT_QUEUE;
+		if (g_replay != NULL) {
+			continue;
+		}
+		if (event->down) {
+			g_state |= event->button;
+			pressed |= event->button;
+		} else {
+			g_state &= ~event->button;
+		}
+		if (now - event->time > g_latency) {
+			g_latency = now - event->time;
+		}
+	}
+
+	// recordings replace live input so sessions play back the same on any machine
+	if (g_replay != NULL) {
+		replay_update();
+	}
+	g_input = g_state | pressed;
+	if (g_record != NULL && g_input != g_record_state) {
+		record_write(g_input);
+		g_record_state = g_input;
+	}
+	++g_tick;
+}
+
+unsigned char bee_input() {
+	return g_input;
+}
@@ -0,0 +1,28 @@
+/*
+ * input.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef INPUT_H_
+#define INPUT_H_
+
+void bee__input_init();
+// queues a button change from the platform with the time it happened
+void bee__input_event(int button, _Bool down);
+// applies the queued events once per tick, before the scene runs
+void bee__input_update();
+
+#endif
@@ -0,0 +1,33 @@
+/*
+ * clock.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../clock.h"
+#include <time.h>
+#include <errno.h>
+
+long long bee__clock_get() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+void bee__clock_sleep(long long duration) {
+	struct timespec time = {duration / 1000000000, duration % 1000000000};
+	// only signals cut the sleep short, anything else would fail the same way again
+	while (nanosleep(&time, &time) != 0 && errno == EINTR);
+}
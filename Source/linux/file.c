@@ -0,0 +1,101 @@
+/*
+ * file.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../file.h"
+#include <mint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <libgen.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static void file_destroy(void* data) {
+	bee__file_t* file = data;
+	if (file->length > 0) {
+		munmap((void*)file->data, file->length);
+	}
+	free(file);
+}
+
+bee__file_t* bee__file_map(const char* path) {
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		return NULL;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) == -1) {
+		close(fd);
+		return NULL;
+	}
+
+	bee__file_t* file = malloc(sizeof(bee__file_t));
+	file->data = NULL;
+	file->length = info.st_size;
+	if (file->length > 0) {
+		file->data = mmap(NULL, file->length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (file->data == MAP_FAILED) {
+			close(fd);
+			free(file);
+			return NULL;
+		}
+	}
+	close(fd);
+	mint_create(file, file_destroy);
+	return file;
+}
+
+_Bool bee__file_replace(const char* path, const void* data, int length) {
+	char temp[4096];
+	if (snprintf(temp, sizeof(temp), "%s.tmp", path) >= (int)sizeof(temp)) {
+		return 0;
+	}
+
+	int fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd == -1) {
+		return 0;
+	}
+	const char* bytes = data;
+	while (length > 0) {
+		ssize_t size = write(fd, bytes, length);
+		if (size == -1) {
+			close(fd);
+			unlink(temp);
+			return 0;
+		}
+		bytes += size;
+		length -= size;
+	}
+	if (fsync(fd) == -1 || close(fd) == -1 || rename(temp, path) == -1) {
+		unlink(temp);
+		return 0;
+	}
+
+	// the rename is only durable once the directory is flushed as well
+	char dir[4096];
+	strcpy(dir, path);
+	fd = open(dirname(dir), O_RDONLY);
+	if (fd != -1) {
+		fsync(fd);
+		close(fd);
+	}
+	return 1;
+}
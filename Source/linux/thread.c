@@ -0,0 +1,114 @@
+/*
+ * thread.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../thread.h"
+#include <mint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct signal_t {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	_Bool posted;
+} signal_t;
+
+typedef struct thread_t {
+	pthread_t handle;
+	bee_callback_t func;
+	void* data;
+} thread_t;
+
+static void* thread_main(void* data) {
+	thread_t* thread = data;
+	thread->func(thread->data);
+	return NULL;
+}
+
+void* bee__thread_create(bee_callback_t func, void* data) {
+	thread_t* thread = malloc(sizeof(thread_t));
+	thread->func = func;
+	thread->data = data;
+	if (pthread_create(&thread->handle, NULL, thread_main, thread) != 0) {
+		mint_fail("LINUX: Failed to create thread");
+	}
+	return thread;
+}
+
+void bee__thread_join(void* data) {
+	thread_t* thread = data;
+	pthread_join(thread->handle, NULL);
+	free(thread);
+}
+
+int bee__thread_cores() {
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+	return cores > 0 ? cores : 1;
+}
+
+void* bee__mutex_create() {
+	pthread_mutex_t* mutex = malloc(sizeof(pthread_mutex_t));
+	pthread_mutex_init(mutex, NULL);
+	return mutex;
+}
+
+void bee__mutex_lock(void* mutex) {
+	pthread_mutex_lock(mutex);
+}
+
+void bee__mutex_unlock(void* mutex) {
+	pthread_mutex_unlock(mutex);
+}
+
+void bee__mutex_destroy(void* mutex) {
+	pthread_mutex_destroy(mutex);
+	free(mutex);
+}
+
+void* bee__signal_create() {
+	signal_t* signal = malloc(sizeof(signal_t));
+	pthread_mutex_init(&signal->mutex, NULL);
+	pthread_cond_init(&signal->cond, NULL);
+	signal->posted = 0;
+	return signal;
+}
+
+void bee__signal_post(void* data) {
+	signal_t* signal = data;
+	pthread_mutex_lock(&signal->mutex);
+	signal->posted = 1;
+	pthread_cond_signal(&signal->cond);
+	pthread_mutex_unlock(&signal->mutex);
+}
+
+void bee__signal_wait(void* data) {
+	signal_t* signal = data;
+	pthread_mutex_lock(&signal->mutex);
+	while (!signal->posted) {
+		pthread_cond_wait(&signal->cond, &signal->mutex);
+	}
+	signal->posted = 0;
+	pthread_mutex_unlock(&signal->mutex);
+}
+
+void bee__signal_destroy(void* data) {
+	signal_t* signal = data;
+	pthread_cond_destroy(&signal->cond);
+	pthread_mutex_destroy(&signal->mutex);
+	free(signal);
+}
@@ -0,0 +1,89 @@
+/*
+ * window.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../window.h"
+#include "../video.h"
+#include "../option.h"
+#include <mint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+static int g_frame = 0;
+static int g_frames = -1;
+static FILE* g_dump;
+static _Bool g_hash;
+
+static void dump_destroy(void* data) {
+	fclose(data);
+}
+
+static void window_readback(void* data) {
+	const unsigned short* pixels = data;
+	if (g_dump != NULL) {
+		fwrite(pixels, sizeof(unsigned short), 128 * 128, g_dump);
+	}
+	if (g_hash) {
+		// FNV-1a over the little-endian pixel bytes
+		uint64_t hash = 0xCBF29CE484222325;
+		for (int i = 0; i < 128 * 128; ++i) {
+			hash = (hash ^ (pixels[i] & 0xFF)) * 0x100000001B3;
+			hash = (hash ^ (pixels[i] >> 8)) * 0x100000001B3;
+		}
+		mint_info("LINUX: Frame %i %016llx", g_frame, (unsigned long long)hash);
+	}
+}
+
+void bee__window_init() {
+	const char* frames = bee__option_get("frames");
+	if (frames != NULL) {
+		g_frames = atoi(frames);
+	}
+
+	const char* dump = bee__option_get("dump");
+	if (dump != NULL) {
+		g_dump = fopen(dump, "wb");
+		if (g_dump == NULL) {
+			mint_fail("LINUX: Failed to open '%s'", dump);
+		}
+		mint_create(g_dump, dump_destroy);
+	}
+
+	g_hash = bee__option_get("hash") != NULL;
+	if (g_dump != NULL || g_hash) {
+		bee__video_readback(window_readback);
+	}
+	mint_info("LINUX: Headless window");
+}
+
+void bee__window_update() {
+	if (g_frame == g_frames) {
+		exit(EXIT_SUCCESS);
+	}
+	++g_frame;
+}
+
+void* bee__window_get() {
+	return NULL;
+}
+
+void bee__window_show() {
+}
+
+void bee__window_present(int width, int height, const unsigned int* data) {
+}
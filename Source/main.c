@@ -19,8 +19,15 @@
 #include "transform.h"
 #include "window.h"
 #include "video.h"
+#include "res.h"
+#include "option.h"
+#include "frame.h"
+#include "profile.h"
+#include "audio.h"
+#include "save.h"
+#include "input.h"
+#include "trace.h"
 #include <mint.h>
-#include <string.h>
 
 static bee_callback_t g_scene = bee_main;
 static void* g_scene_data;
@@ -31,31 +38,45 @@ void bee_scene(bee_callback_t scene, void* data) {
 }
 
 int main(int argc, char* argv[]) {
-	_Bool editor = 0;
-	for (int i = 1; i < argc; ++i) {
-		if (strcmp(argv[i], "editor") == 0) {
-			editor = 1;
-		} else {
-			mint_warn("ARG: Unknown command '%s'", argv[i]);
-		}
-	}
-
+	bee__option_init(argc, argv);
 	mint_init("8bee.log");
 	bee__transform_init();
 	bee__window_init();
+	bee__trace_init();
 	bee__video_init();
+	bee__frame_init();
+	bee__profile_init();
+	bee__audio_init();
+	bee__save_init();
+	bee__input_init();
 
-	if (editor) {
+	if (bee__option_get("editor") != NULL) {
 		mint_info("ARG: Starting editor");
 	} else {
-		// bee__res_init();
+		bee__res_init();
 	}
 
+	bee__option_check();
 	bee__window_show();
 
 	for (;;) {
+		bee__frame_begin();
+
+		long long begin = bee__profile_begin();
 		bee__window_update();
+		bee__input_update();
+		bee__profile_end(BEE__PROFILE_WINDOW, begin);
+
+		begin = bee__profile_begin();
+		bee__audio_update();
 		g_scene(g_scene_data);
+		bee__profile_end(BEE__PROFILE_SCENE, begin);
+
+		begin = bee__profile_begin();
 		bee__video_update();
+		bee__profile_end(BEE__PROFILE_VIDEO, begin);
+
+		bee__frame_end();
+		bee__profile_frame();
 	}
 }
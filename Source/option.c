@@ -0,0 +1,57 @@
+/*
+ * option.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "option.h"
+#include <mint.h>
+#include <string.h>
+
+static int g_count;
+static char** g_args;
+static _Bool* g_used;
+
+void bee__option_init(int argc, char* argv[]) {
+	g_count = argc - 1;
+	g_args = argv + 1;
+	mint_array_check(g_used, g_count);
+	memset(g_used, 0, g_count * sizeof(_Bool));
+}
+
+const char* bee__option_get(const char* name) {
+	size_t length = strlen(name);
+	for (int i = 0; i < g_count; ++i) {
+		const char* arg = g_args[i];
+		if (strncmp(arg, name, length) == 0) {
+			if (arg[length] == '\0') {
+				g_used[i] = 1;
+				return arg + length;
+			} else if (arg[length] == '=') {
+				g_used[i] = 1;
+				return arg + length + 1;
+			}
+		}
+	}
+	return NULL;
+}
+
+void bee__option_check() {
+	for (int i = 0; i < g_count; ++i) {
+		if (!g_used[i]) {
+			mint_warn("ARG: Unknown command '%s'", g_args[i]);
+		}
+	}
+}
@@ -0,0 +1,27 @@
+/*
+ * option.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OPTION_H_
+#define OPTION_H_
+
+// options are passed as 'name' or 'name=value' arguments
+void bee__option_init(int argc, char* argv[]);
+const char* bee__option_get(const char* name);
+void bee__option_check();
+
+#endif
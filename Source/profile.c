@@ -0,0 +1,122 @@
+/*
+ * profile.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "profile.h"
+#include "option.h"
+#include <8bee.h>
+#include <mint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILE_FRAMES 256
+
+_Bool bee__profile_enabled = 0;
+long long bee__profile_times[BEE__PROFILE_PHASES];
+int bee__profile_counters[BEE__PROFILE_COUNTERS];
+
+static bee_profile_t g_frames[PROFILE_FRAMES];
+static int g_frame = 0;
+static int g_summary = 0;
+
+static int profile_micro(long long time) {
+	return time / 1000;
+}
+
+static void profile_summary() {
+	bee_profile_t sum = {0};
+	int high = 0;
+	int count = g_summary < PROFILE_FRAMES ? g_summary : PROFILE_FRAMES;
+	for (int i = 1; i <= count; ++i) {
+		bee_profile_t* frame = g_frames + (g_frame - i) % PROFILE_FRAMES;
+		sum.window += frame->window;
+		sum.scene += frame->scene;
+		sum.video += frame->video;
+		sum.flush += frame->flush;
+		sum.bind += frame->bind;
+		sum.target += frame->target;
+		sum.sprites += frame->sprites;
+		sum.flushes += frame->flushes;
+		sum.draws += frame->draws;
+		sum.binds += frame->binds;
+		sum.targets += frame->targets;
+		sum.skips += frame->skips;
+		sum.redundant += frame->redundant;
+		sum.arena += frame->arena;
+		if (frame->arena > high) {
+			high = frame->arena;
+		}
+	}
+
+	mint_info("PROFILE: %i frames, avg us window %i scene %i video %i flush %i bind %i target %i",
+			count, sum.window / count, sum.scene / count, sum.video / count,
+			sum.flush / count, sum.bind / count, sum.target / count);
+	mint_info("PROFILE: avg per frame sprites %i flushes %i draws %i binds %i targets %i redundant %i, %i skipped",
+			sum.sprites / count, sum.flushes / count, sum.draws / count,
+			sum.binds / count, sum.targets / count, sum.redundant / count, sum.skips);
+	mint_info("PROFILE: avg arena %i bytes, high water %i bytes", sum.arena / count, high);
+}
+
+void bee__profile_init() {
+	const char* option = bee__option_get("profile");
+	if (option != NULL) {
+		bee__profile_enabled = 1;
+		g_summary = *option == '\0' ? 0 : atoi(option);
+		if (g_summary <= 0) {
+			g_summary = 60;
+		}
+		mint_info("PROFILE: Summary every %i frames", g_summary);
+	}
+}
+
+void bee__profile_frame() {
+	bee_profile_t* frame = g_frames + g_frame % PROFILE_FRAMES;
+	frame->window = profile_micro(bee__profile_times[BEE__PROFILE_WINDOW]);
+	frame->scene = profile_micro(bee__profile_times[BEE__PROFILE_SCENE]);
+	frame->video = profile_micro(bee__profile_times[BEE__PROFILE_VIDEO]);
+	frame->flush = profile_micro(bee__profile_times[BEE__PROFILE_FLUSH]);
+	frame->bind = profile_micro(bee__profile_times[BEE__PROFILE_BIND]);
+	frame->target = profile_micro(bee__profile_times[BEE__PROFILE_TARGET]);
+	frame->sprites = bee__profile_counters[BEE__PROFILE_SPRITES];
+	frame->flushes = bee__profile_counters[BEE__PROFILE_FLUSHES];
+	frame->draws = bee__profile_counters[BEE__PROFILE_DRAWS];
+	frame->binds = bee__profile_counters[BEE__PROFILE_BINDS];
+	frame->targets = bee__profile_counters[BEE__PROFILE_TARGETS];
+	frame->skips = bee__profile_counters[BEE__PROFILE_SKIPS];
+	frame->redundant = bee__profile_counters[BEE__PROFILE_REDUNDANT];
+	frame->arena = bee__profile_counters[BEE__PROFILE_ARENA];
+	memset(bee__profile_times, 0, sizeof(bee__profile_times));
+	memset(bee__profile_counters, 0, sizeof(bee__profile_counters));
+
+	++g_frame;
+	if (bee__profile_enabled && g_frame % g_summary == 0) {
+		profile_summary();
+	}
+}
+
+int bee_profile(bee_profile_t* frames, int count) {
+	if (count > g_frame) {
+		count = g_frame;
+	}
+	if (count > PROFILE_FRAMES) {
+		count = PROFILE_FRAMES;
+	}
+	for (int i = 0; i < count; ++i) {
+		frames[i] = g_frames[(g_frame - count + i) % PROFILE_FRAMES];
+	}
+	return count;
+}
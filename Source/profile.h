@@ -0,0 +1,67 @@
+/*
+ * profile.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+#include "clock.h"
+
+typedef enum bee__profile_phase_t {
+	BEE__PROFILE_WINDOW,
+	BEE__PROFILE_SCENE,
+	BEE__PROFILE_VIDEO,
+	BEE__PROFILE_FLUSH,
+	BEE__PROFILE_BIND,
+	BEE__PROFILE_TARGET,
+	BEE__PROFILE_PHASES
+} bee__profile_phase_t;
+
+typedef enum bee__profile_counter_t {
+	BEE__PROFILE_SPRITES,
+	BEE__PROFILE_FLUSHES,
+	BEE__PROFILE_DRAWS,
+	BEE__PROFILE_BINDS,
+	BEE__PROFILE_TARGETS,
+	BEE__PROFILE_SKIPS,
+	BEE__PROFILE_REDUNDANT,
+	BEE__PROFILE_ARENA,
+	BEE__PROFILE_COUNTERS
+} bee__profile_counter_t;
+
+extern _Bool bee__profile_enabled;
+extern long long bee__profile_times[BEE__PROFILE_PHASES];
+extern int bee__profile_counters[BEE__PROFILE_COUNTERS];
+
+void bee__profile_init();
+void bee__profile_frame();
+
+// the profiling hooks only touch the clock when profiling is enabled
+static inline long long bee__profile_begin() {
+	return bee__profile_enabled ? bee__clock_get() : 0;
+}
+
+static inline void bee__profile_end(bee__profile_phase_t phase, long long begin) {
+	if (bee__profile_enabled) {
+		bee__profile_times[phase] += bee__clock_get() - begin;
+	}
+}
+
+static inline void bee__profile_count(bee__profile_counter_t counter, int count) {
+	bee__profile_counters[counter] += count;
+}
+
+#endif
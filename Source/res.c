@@ -17,83 +17,387 @@
  */
 
 #include "res.h"
-#include "video.h"
+#include "atlas.h"
+#include "chunk.h"
+#include "file.h"
+#include "option.h"
+#include <8bee.h>
 #include <mint.h>
 #include <stdint.h>
+#include <string.h>
 
-typedef struct stream_t {
-	int length;
-	const unsigned char* data;
-	int index;
-} stream_t;
+#define RES_PIXELS BEE__CHUNK_PIXELS
 
-static uint8_t res_read8(stream_t* stream) {
-	if (stream->index == stream->length) {
+// colour literals are given their own palette entries after the resource colours
+#define RES_PALETTE 256
+
+#define RES_STREAM 0x22010480
+#define RES_INDEXED 0x22010481
+
+static const uint16_t g_colors[] = {
+		0x0000, 0x005F, 0x00AF, 0x00FF, 0x050F, 0x055F, 0x05AF, 0x05FF,
+		0x0A0F, 0x0A5F, 0x0AAF, 0x0AFF, 0x0F0F, 0x0F5F, 0x0FAF, 0x0FFF,
+		0x500F, 0x505F, 0x50AF, 0x50FF, 0x550F, 0x555F, 0x55AF, 0x55FF,
+		0x5A0F, 0x5A5F, 0x5AAF, 0x5AFF, 0x5F0F, 0x5F5F, 0x5FAF, 0x5FFF,
+		0xA00F, 0xA05F, 0xA0AF, 0xA0FF, 0xA50F, 0xA55F, 0xA5AF, 0xA5FF,
+		0xAA0F, 0xAA5F, 0xAAAF, 0xAAFF, 0xAF0F, 0xAF5F, 0xAFAF, 0xAFFF,
+		0xF00F, 0xF05F, 0xF0AF, 0xF0FF, 0xF50F, 0xF55F, 0xF5AF, 0xF5FF,
+		0xFA0F, 0xFA5F, 0xFAAF, 0xFAFF, 0xFF0F, 0xFF5F, 0xFFAF, 0xFFFF
+};
+
+// palette entry of every 12-bit colour literal, zero if it has not been given one
+static uint8_t g_literals[0x1000];
+static int g_literal_count = 0;
+static _Bool g_direct;
+
+static void res_fill(uint16_t* buffer, uint16_t color, int count) {
+	uint64_t wide = color * 0x0001000100010001ULL;
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		memcpy(buffer + i, &wide, sizeof(wide));
+	}
+	for (; i < count; ++i) {
+		buffer[i] = color;
+	}
+}
+
+// reads the length and distance of a back-reference after its token
+static const unsigned char* res_match(const unsigned char* data, const unsigned char* end,
+		uint8_t value, int* count, int* distance) {
+	*count = value - BEE__CHUNK_MATCH + BEE__CHUNK_MATCH_MIN;
+	if (*count == BEE__CHUNK_MATCH_LONG) {
+		*count += *data++;
+	}
+	if (end - data < 2) {
 		mint_fail("RES: Unexpected end of file");
 	}
-	return stream->data[stream->index++];
+	int back = *data++;
+	if (back & 0x80) {
+		if (end - data < 2) {
+			mint_fail("RES: Unexpected end of file");
+		}
+		back = ((back & 0x7F) << 8) | *data++;
+	}
+	*distance = back + 1;
+	return data;
 }
 
-static uint16_t res_read16(stream_t* stream) {
-	uint8_t b0 = res_read8(stream);
-	uint8_t b1 = res_read8(stream);
-	return (b0 << 8) | b1;
+// decodes a chunk and returns its length in bytes
+static int res_decode(int length, const unsigned char* data, _Bool lz, uint16_t* buffer) {
+	const unsigned char* start = data;
+	const unsigned char* end = data + length;
+	uint16_t* pixel = buffer;
+	uint16_t* last = buffer + RES_PIXELS;
+	while (pixel < last) {
+		// every token is followed by at least one byte, either a colour or the next chunk type,
+		// so checking for two bytes covers colour literals as well
+		if (end - data < 2) {
+			mint_fail("RES: Unexpected end of file");
+		}
+
+		uint8_t value = *data++;
+		if (value & 0x80) {
+			int count = (value & 0x7F) + 1;
+			if (pixel == buffer || count > last - pixel) {
+				mint_fail("RES: Invalid data chunk");
+			}
+			res_fill(pixel, pixel[-1], count);
+			pixel += count;
+		} else if (lz && value >= BEE__CHUNK_MATCH) {
+			int count, distance;
+			data = res_match(data, end, value, &count, &distance);
+			if (distance > pixel - buffer || count > last - pixel) {
+				mint_fail("RES: Invalid data chunk");
+			}
+			const uint16_t* src = pixel - distance;
+			if (distance >= count) {
+				memcpy(pixel, src, count * sizeof(uint16_t));
+			} else {
+				for (int i = 0; i < count; ++i) {
+					pixel[i] = src[i];
+				}
+			}
+			pixel += count;
+		} else if (value & 0x40) {
+			*pixel++ = ((value & 0x0F) << 12) | (*data++ << 4) | 0xF;
+		} else {
+			*pixel++ = g_colors[value];
+		}
+	}
+	return data - start;
 }
 
-static uint32_t res_read32(stream_t* stream) {
-	uint16_t b0 = res_read16(stream);
-	uint16_t b1 = res_read16(stream);
-	return (b0 << 16) | b1;
+// decodes a chunk to palette indices and returns its length in bytes,
+// or -1 if it has more new colour literals than the palette has room for
+static int res_decode_indexed(int length, const unsigned char* data, _Bool lz, uint8_t* buffer) {
+	if (g_literal_count == 0) {
+		bee__atlas_palette(0, BEE_PALETTE_SIZE, g_colors);
+		g_literal_count = BEE_PALETTE_SIZE;
+	}
+
+	const unsigned char* start = data;
+	const unsigned char* end = data + length;
+	uint8_t* pixel = buffer;
+	uint8_t* last = buffer + RES_PIXELS;
+	while (pixel < last) {
+		if (end - data < 2) {
+			mint_fail("RES: Unexpected end of file");
+		}
+
+		uint8_t value = *data++;
+		if (value & 0x80) {
+			int count = (value & 0x7F) + 1;
+			if (pixel == buffer || count > last - pixel) {
+				mint_fail("RES: Invalid data chunk");
+			}
+			memset(pixel, pixel[-1], count);
+			pixel += count;
+		} else if (lz && value >= BEE__CHUNK_MATCH) {
+			int count, distance;
+			data = res_match(data, end, value, &count, &distance);
+			if (distance > pixel - buffer || count > last - pixel) {
+				mint_fail("RES: Invalid data chunk");
+			}
+			const uint8_t* src = pixel - distance;
+			if (distance >= count) {
+				memcpy(pixel, src, count);
+			} else {
+				for (int i = 0; i < count; ++i) {
+					pixel[i] = src[i];
+				}
+			}
+			pixel += count;
+		} else if (value & 0x40) {
+			int rgb = ((value & 0x0F) << 8) | *data++;
+			if (g_literals[rgb] == 0) {
+				if (g_literal_count == RES_PALETTE) {
+					return -1;
+				}
+				uint16_t color = (rgb << 4) | 0xF;
+				bee__atlas_palette(g_literal_count, 1, &color);
+				g_literals[rgb] = g_literal_count++;
+			}
+			*pixel++ = g_literals[rgb];
+		} else {
+			*pixel++ = value;
+		}
+	}
+	return data - start;
+}
+
+// walks the tokens of a chunk without decoding it and returns its length in bytes
+static int res_skip(int length, const unsigned char* data, _Bool lz) {
+	int index = 0;
+	int pixels = 0;
+	while (pixels < RES_PIXELS) {
+		if (length - index < 2) {
+			mint_fail("RES: Unexpected end of file");
+		}
+
+		uint8_t value = data[index++];
+		if (value & 0x80) {
+			if (pixels == 0) {
+				mint_fail("RES: Invalid data chunk");
+			}
+			pixels += (value & 0x7F) + 1;
+		} else if (lz && value >= BEE__CHUNK_MATCH) {
+			int count, distance;
+			index = res_match(data + index, data + length, value, &count, &distance) - data;
+			if (distance > pixels) {
+				mint_fail("RES: Invalid data chunk");
+			}
+			pixels += count;
+		} else {
+			pixels += 1;
+			if (value & 0x40) {
+				++index;
+			}
+		}
+	}
+
+	if (pixels != RES_PIXELS) {
+		mint_fail("RES: Invalid data chunk");
+	}
+	return index;
+}
+
+static int res_chunk(uint8_t type, int page, int length, const unsigned char* data) {
+	static uint16_t scratch[RES_PIXELS];
+	_Bool lz = type & BEE__CHUNK_LZ;
+	int size;
+	switch (type & ~BEE__CHUNK_LZ) {
+	case BEE__CHUNK_VIDEO:
+		// pages fall back to colours when they run out of palette
+		size = g_direct ? -1 : res_decode_indexed(length, data, lz, bee__atlas_map_indexed(page));
+		if (size == -1) {
+			size = res_decode(length, data, lz, bee__atlas_map(page));
+		}
+		bee__atlas_unmap(page);
+		break;
+	default:
+		size = res_decode(length, data, lz, scratch);
+		break;
+	}
+	return size;
 }
 
-void bee__res_data(int length, const unsigned char* data) {
-	static const uint16_t colors[] = {
-			0x0000, 0x005F, 0x00AF, 0x00FF, 0x050F, 0x055F, 0x05AF, 0x05FF,
-			0x0A0F, 0x0A5F, 0x0AAF, 0x0AFF, 0x0F0F, 0x0F5F, 0x0FAF, 0x0FFF,
-			0x500F, 0x505F, 0x50AF, 0x50FF, 0x550F, 0x555F, 0x55AF, 0x55FF,
-			0x5A0F, 0x5A5F, 0x5AAF, 0x5AFF, 0x5F0F, 0x5F5F, 0x5FAF, 0x5FFF,
-			0xA00F, 0xA05F, 0xA0AF, 0xA0FF, 0xA50F, 0xA55F, 0xA5AF, 0xA5FF,
-			0xAA0F, 0xAA5F, 0xAAAF, 0xAAFF, 0xAF0F, 0xAF5F, 0xAFAF, 0xAFFF,
-			0xF00F, 0xF05F, 0xF0AF, 0xF0FF, 0xF50F, 0xF55F, 0xF5AF, 0xF5FF,
-			0xFA0F, 0xFA5F, 0xFAAF, 0xFAFF, 0xFF0F, 0xFF5F, 0xFFAF, 0xFFFF
-	};
+static uint32_t res_read32(const unsigned char* data) {
+	return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
 
-	stream_t stream = {length, data, 0};
-	if (res_read32(&stream) != 0x22010480) {
+void bee__res_data(int length, const unsigned char* data, int page) {
+	if (length < 4 || res_read32(data) != RES_STREAM) {
 		mint_fail("RES: Invalid header");
 	}
 
+	int index = 4;
 	for (;;) {
-		uint8_t type = res_read8(&stream);
-		if (type == 0x1A) {
+		if (index >= length) {
+			mint_fail("RES: Unexpected end of file");
+		}
+		uint8_t type = data[index++];
+		if (type == BEE__CHUNK_END) {
 			break;
 		}
+		_Bool video = (type & ~BEE__CHUNK_LZ) == BEE__CHUNK_VIDEO;
+		while (video && page >= bee__atlas_count()) {
+			bee__atlas_alloc();
+		}
+		index += res_chunk(type, page, length - index, data + index);
+		if (video) {
+			++page;
+		}
+	}
+}
 
-		uint16_t buffer[128 * 128];
-		int count = 0;
-		for (int i = 0; i < 128 * 128;) {
-			if (count > 0) {
-				buffer[i] = buffer[i - 1];
-				--count;
-			} else {
-				uint8_t value = res_read8(&stream);
-				if (value & 0x80) {
-					count = value & 0x7F;
-					if (i == 0) {
-						mint_fail("RES: Invalid data chunk");
-					}
-					buffer[i] = buffer[i - 1];
-				} else if (value & 0x40) {
-					buffer[i] = ((value & 0x0F) << 12) | (res_read8(&stream) << 4) | 0xF;
-				} else {
-					buffer[i] = colors[value];
-				}
-			}
+static bee__file_t* g_file;
+static bee__res_chunk_t* g_chunks;
+static int g_chunk_count = 0;
+
+static bee__res_chunk_t* res_append() {
+	mint_array_check(g_chunks, g_chunk_count + 1);
+	return g_chunks + g_chunk_count++;
+}
+
+// builds the chunk index for packs that do not have one by walking the stream once
+static void res_index_stream() {
+	int length = g_file->length;
+	const unsigned char* data = g_file->data;
+	int index = 4;
+	for (;;) {
+		if (index >= length) {
+			mint_fail("RES: Unexpected end of file");
+		}
+		uint8_t type = data[index++];
+		if (type == BEE__CHUNK_END) {
+			break;
+		}
+
+		bee__res_chunk_t* chunk = res_append();
+		chunk->type = type;
+		chunk->page = -1;
+		chunk->offset = index;
+		chunk->length = res_skip(length - index, data + index, type & BEE__CHUNK_LZ);
+		index += chunk->length;
+	}
+}
+
+// indexed packs store a chunk count followed by 9 byte entries of type, offset and length
+static void res_index_table() {
+	int length = g_file->length;
+	const unsigned char* data = g_file->data;
+	if (length < 6) {
+		mint_fail("RES: Unexpected end of file");
+	}
+
+	int count = (data[4] << 8) | data[5];
+	if (length < 6 + count * 9) {
+		mint_fail("RES: Unexpected end of file");
+	}
+	for (int i = 0; i < count; ++i) {
+		const unsigned char* entry = data + 6 + i * 9;
+		bee__res_chunk_t* chunk = res_append();
+		chunk->type = entry[0];
+		chunk->page = -1;
+		chunk->offset = res_read32(entry + 1);
+		chunk->length = res_read32(entry + 5);
+
+		// chunks are followed by at least the terminator
+		if (chunk->offset < 6 + count * 9 || chunk->length < 1
+				|| chunk->offset >= length || chunk->length >= length - chunk->offset) {
+			mint_fail("RES: Invalid chunk table");
 		}
+	}
+}
+
+_Bool bee__res_open(const char* path) {
+	g_file = bee__file_map(path);
+	if (g_file == NULL) {
+		return 0;
+	}
+	if (g_file->length < 4) {
+		mint_fail("RES: Invalid header");
+	}
+
+	g_chunk_count = 0;
+	switch (res_read32(g_file->data)) {
+	case RES_STREAM:
+		res_index_stream();
+		break;
+	case RES_INDEXED:
+		res_index_table();
+		break;
+	default:
+		mint_fail("RES: Invalid header");
+	}
+	mint_info("RES: %i chunks in '%s'", g_chunk_count, path);
+	return 1;
+}
+
+int bee__res_count() {
+	return g_chunk_count;
+}
+
+const bee__res_chunk_t* bee__res_chunk(int index) {
+	return g_chunks + index;
+}
+
+void bee__res_load(int index) {
+	if (index < 0 || index >= g_chunk_count) {
+		mint_fail("RES: Invalid chunk %i", index);
+	}
+	bee__res_chunk_t* chunk = g_chunks + index;
+	if ((chunk->type & ~BEE__CHUNK_LZ) == BEE__CHUNK_VIDEO && chunk->page == -1) {
+		chunk->page = bee__atlas_alloc();
+	}
+	int length = g_file->length - chunk->offset;
+	if (res_chunk(chunk->type, chunk->page, length, g_file->data + chunk->offset) != chunk->length) {
+		mint_fail("RES: Invalid data chunk");
+	}
+}
+
+void bee__res_init() {
+	const char* path = bee__option_get("res");
+	_Bool required = path != NULL;
+	if (!required) {
+		path = "8bee.bee";
+	}
+	g_direct = bee__option_get("direct") != NULL;
+
+	// games with their resources built in have no pack to load
+	if (!bee__res_open(path)) {
+		if (required) {
+			mint_fail("RES: Failed to open '%s'", path);
+		}
+		mint_warn("RES: No pack at '%s'", path);
+		return;
+	}
 
-		switch (type) {
-		case 0x15:
-			bee__video_data(buffer);
+	// every video chunk gets its own atlas page, numbered in pack order but decoded when first drawn
+	for (int i = 0; i < g_chunk_count; ++i) {
+		if ((g_chunks[i].type & ~BEE__CHUNK_LZ) == BEE__CHUNK_VIDEO) {
+			g_chunks[i].page = bee__atlas_alloc();
+			bee__atlas_defer(g_chunks[i].page, bee__res_load, i);
 		}
 	}
 }
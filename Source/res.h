@@ -19,6 +19,21 @@
 #ifndef RES_H_
 #define RES_H_
 
-void bee__res_data(int length, const unsigned char* data);
+typedef struct bee__res_chunk_t {
+	int type;
+	int page;
+	int offset;
+	int length;
+} bee__res_chunk_t;
+
+// video chunks are decoded into consecutive atlas pages starting at page
+void bee__res_data(int length, const unsigned char* data, int page);
+
+// packs are mapped from disk and their chunks decoded on demand, returns 0 if it can not be opened
+_Bool bee__res_open(const char* path);
+int bee__res_count();
+const bee__res_chunk_t* bee__res_chunk(int index);
+void bee__res_load(int index);
+void bee__res_init();
 
 #endif
@@ -0,0 +1,138 @@
+/*
+ * save.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "save.h"
+#include "thread.h"
+#include "clock.h"
+#include "file.h"
+#include "option.h"
+#include <8bee.h>
+#include <mint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+// saves requested within this long of each other are written once
+#define SAVE_WINDOW 16000000
+
+typedef struct buffer_t {
+	void* data;
+	int length;
+	int capacity;
+	unsigned int request;
+} buffer_t;
+
+static const char* g_path;
+static void* g_thread;
+static void* g_mutex;
+static void* g_signal;
+static _Bool g_quit;
+
+// the game thread fills the pending buffer and the worker swaps it out to write
+static buffer_t g_buffers[2];
+static buffer_t* g_pending = g_buffers;
+static buffer_t* g_writing = g_buffers + 1;
+static _Bool g_dirty;
+
+static unsigned int g_requested = 0;
+static atomic_uint g_written;
+static atomic_int g_failed;
+static bee_save_t g_save;
+
+static void save_thread(void* data) {
+	for (;;) {
+		bee__signal_wait(g_signal);
+
+		bee__mutex_lock(g_mutex);
+		_Bool quit = g_quit;
+		bee__mutex_unlock(g_mutex);
+		if (!quit) {
+			bee__clock_sleep(SAVE_WINDOW);
+		}
+
+		bee__mutex_lock(g_mutex);
+		_Bool dirty = g_dirty;
+		if (dirty) {
+			buffer_t* swap = g_pending;
+			g_pending = g_writing;
+			g_writing = swap;
+			g_dirty = 0;
+		}
+		quit = g_quit;
+		bee__mutex_unlock(g_mutex);
+
+		if (dirty) {
+			if (bee__file_replace(g_path, g_writing->data, g_writing->length)) {
+				atomic_store(&g_failed, 0);
+				atomic_store(&g_written, g_writing->request);
+			} else {
+				atomic_store(&g_failed, 1);
+				mint_warn("SAVE: Failed to write '%s'", g_path);
+			}
+		}
+		if (quit) {
+			break;
+		}
+	}
+}
+
+static void save_destroy(void* data) {
+	// pending saves are still written before we exit
+	bee__mutex_lock(g_mutex);
+	g_quit = 1;
+	bee__mutex_unlock(g_mutex);
+	bee__signal_post(g_signal);
+	bee__thread_join(g_thread);
+	bee__signal_destroy(g_signal);
+	bee__mutex_destroy(g_mutex);
+	free(g_buffers[0].data);
+	free(g_buffers[1].data);
+}
+
+void bee__save_init() {
+	g_path = bee__option_get("save");
+	if (g_path == NULL) {
+		g_path = "8bee.sav";
+	}
+
+	g_mutex = bee__mutex_create();
+	g_signal = bee__signal_create();
+	g_thread = bee__thread_create(save_thread, NULL);
+	mint_create(&g_thread, save_destroy);
+}
+
+void bee_savedata(void* data, int length) {
+	bee__mutex_lock(g_mutex);
+	if (g_pending->capacity < length) {
+		g_pending->data = realloc(g_pending->data, length);
+		g_pending->capacity = length;
+	}
+	memcpy(g_pending->data, data, length);
+	g_pending->length = length;
+	g_pending->request = ++g_requested;
+	g_dirty = 1;
+	bee__mutex_unlock(g_mutex);
+	bee__signal_post(g_signal);
+}
+
+const bee_save_t* bee_save() {
+	g_save.requested = g_requested;
+	g_save.written = atomic_load(&g_written);
+	g_save.failed = atomic_load(&g_failed);
+	return &g_save;
+}
@@ -0,0 +1,721 @@
+/*
+ * video.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../video.h"
+#include "../window.h"
+#include "../profile.h"
+#include "../option.h"
+#include "../thread.h"
+#include <mint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <stdatomic.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// u and v coordinates are stepped in 16.16 fixed point
+#define FIXED_ONE 0x10000
+
+// draws are binned into square tiles that are rasterised in parallel
+#define TILE_SIZE 32
+
+// source rows converted and scaled per job when presenting
+#define PRESENT_ROWS 8
+
+#define WORKER_MAX 16
+
+// indexed textures also keep their indices and look them up into data when they are drawn
+// with a palette or indices that changed, so drawing itself stays a copy
+typedef struct texture_t {
+	int width;
+	int height;
+	uint16_t* data;
+	uint8_t* indices;
+	unsigned int palette;
+} texture_t;
+
+typedef struct rect_t {
+	int left, bottom, right, top;
+} rect_t;
+
+typedef enum command_type_t {
+	COMMAND_CLEAR,
+	COMMAND_ALIGNED,
+	COMMAND_AFFINE
+} command_type_t;
+
+// everything a tile needs to draw its part of a sprite, worked out once when it is queued
+typedef struct command_t {
+	command_type_t type;
+	const texture_t* texture;
+	bee_sprite_t sprite;
+	rect_t bounds;
+	// the unclipped corner the texture coordinates are stepped from
+	int left, bottom;
+	int32_t u, du, v, dv;
+	float a, b, c, d, tx, ty, det;
+} command_t;
+
+typedef void (*job_t)(int index);
+
+typedef struct worker_t {
+	void* thread;
+	void* start;
+	void* done;
+} worker_t;
+
+static texture_t g_screen;
+static texture_t* g_target;
+static uint32_t* g_present;
+static const texture_t* g_present_source;
+static int g_present_scale;
+static uint16_t g_palette[256];
+static unsigned int g_palette_version = 1;
+
+static command_t* g_commands;
+static int g_command_count = 0;
+static int* g_bins;
+static int* g_bin_starts;
+static int g_bin_capacity = 0;
+
+static worker_t g_workers[WORKER_MAX];
+static int g_worker_count = 0;
+static _Bool g_quit;
+static job_t g_job;
+static int g_job_count;
+static atomic_int g_job_next;
+
+static void texture_destroy(void* data) {
+	texture_t* texture = data;
+	free(texture->data);
+	free(texture->indices);
+	free(texture);
+}
+
+static void buffer_destroy(void* data) {
+	free(data);
+}
+
+static void span_copy(uint16_t* dst, const uint16_t* src, int count) {
+	memcpy(dst, src, count * sizeof(uint16_t));
+}
+
+static void span_reverse(uint16_t* dst, const uint16_t* src, int count) {
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 8 <= count; i += 8) {
+		__m128i value = _mm_loadu_si128((const __m128i*)(src - i - 7));
+		value = _mm_shuffle_epi32(value, _MM_SHUFFLE(0, 1, 2, 3));
+		value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+		value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128((__m128i*)(dst + i), value);
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = src[-i];
+	}
+}
+
+static void span_repeat4(uint16_t* dst, const uint16_t* src, int count) {
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 32 <= count; i += 32) {
+		__m128i value = _mm_loadu_si128((const __m128i*)(src + i / 4));
+		__m128i lo = _mm_unpacklo_epi16(value, value);
+		__m128i hi = _mm_unpackhi_epi16(value, value);
+		_mm_storeu_si128((__m128i*)(dst + i + 0), _mm_unpacklo_epi32(lo, lo));
+		_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi32(lo, lo));
+		_mm_storeu_si128((__m128i*)(dst + i + 16), _mm_unpacklo_epi32(hi, hi));
+		_mm_storeu_si128((__m128i*)(dst + i + 24), _mm_unpackhi_epi32(hi, hi));
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = src[i / 4];
+	}
+}
+
+static void span_repeat2(uint16_t* dst, const uint16_t* src, int count) {
+	int i = 0;
+#ifdef __SSE2__
+	for (; i + 16 <= count; i += 16) {
+		__m128i value = _mm_loadu_si128((const __m128i*)(src + i / 2));
+		_mm_storeu_si128((__m128i*)(dst + i + 0), _mm_unpacklo_epi16(value, value));
+		_mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi16(value, value));
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = src[i / 2];
+	}
+}
+
+static void span_scale(uint16_t* dst, const uint16_t* src, int count, int32_t u, int32_t du) {
+	for (int i = 0; i < count; ++i) {
+		dst[i] = src[u >> 16];
+		u += du;
+	}
+}
+
+// draws a row where the texel only depends on the column
+static void span_draw(uint16_t* dst, const uint16_t* src, int count, int32_t u, int32_t du) {
+	if (du == FIXED_ONE) {
+		span_copy(dst, src + (u >> 16), count);
+	} else if (du == -FIXED_ONE) {
+		span_reverse(dst, src + (u >> 16), count);
+	} else if (du == FIXED_ONE / 4 || du == FIXED_ONE / 2) {
+		// step until we reach the start of a texel
+		int head = 0;
+		while (head < count && (u & 0xFFFF) >= du) {
+			dst[head++] = src[u >> 16];
+			u += du;
+		}
+		if (du == FIXED_ONE / 4) {
+			span_repeat4(dst + head, src + (u >> 16), count - head);
+		} else {
+			span_repeat2(dst + head, src + (u >> 16), count - head);
+		}
+	} else {
+		span_scale(dst, src, count, u, du);
+	}
+}
+
+static int32_t soft_fixed(float value) {
+	return lrintf(value * FIXED_ONE);
+}
+
+// divides two 16.16 values rounding to the nearest
+static int32_t soft_div(int64_t num, int64_t den) {
+	num *= FIXED_ONE;
+	if ((num < 0) != (den < 0)) {
+		return (num - den / 2) / den;
+	}
+	return (num + den / 2) / den;
+}
+
+// the first pixel whose centre is at or past a 16.16 position
+static int soft_snap(int64_t value) {
+	return (value + FIXED_ONE / 2 - 1) >> 16;
+}
+
+static void job_run() {
+	for (;;) {
+		int index = atomic_fetch_add(&g_job_next, 1);
+		if (index >= g_job_count) {
+			break;
+		}
+		g_job(index);
+	}
+}
+
+static void worker_main(void* data) {
+	worker_t* worker = data;
+	for (;;) {
+		bee__signal_wait(worker->start);
+		if (g_quit) {
+			break;
+		}
+		job_run();
+		bee__signal_post(worker->done);
+	}
+}
+
+static void worker_destroy(void* data) {
+	g_quit = 1;
+	for (int i = 0; i < g_worker_count; ++i) {
+		bee__signal_post(g_workers[i].start);
+		bee__thread_join(g_workers[i].thread);
+	}
+}
+
+// runs the job for every index across the workers and this thread
+static void soft_parallel(job_t job, int count) {
+	g_job = job;
+	g_job_count = count;
+	atomic_store(&g_job_next, 0);
+	int workers = count - 1 < g_worker_count ? count - 1 : g_worker_count;
+	for (int i = 0; i < workers; ++i) {
+		bee__signal_post(g_workers[i].start);
+	}
+	job_run();
+	for (int i = 0; i < workers; ++i) {
+		bee__signal_wait(g_workers[i].done);
+	}
+}
+
+static void soft_draw_aligned(const command_t* command, const rect_t* clip) {
+	const texture_t* texture = command->texture;
+	const bee_sprite_t* sprite = &command->sprite;
+	int32_t u = command->u + command->du * (clip->left - command->left);
+	int32_t v = command->v + command->dv * (clip->bottom - command->bottom);
+	int32_t vmax = sprite->h << 16;
+	for (int y = clip->bottom; y < clip->top; ++y, v += command->dv) {
+		if (v < 0 || v >= vmax) {
+			continue;
+		}
+		const uint16_t* src = texture->data + (sprite->y + (v >> 16)) * texture->width + sprite->x;
+		uint16_t* dst = g_target->data + y * g_target->width + clip->left;
+		span_draw(dst, src, clip->right - clip->left, u, command->du);
+	}
+}
+
+static void soft_draw_affine(const command_t* command, const rect_t* clip) {
+	const texture_t* texture = command->texture;
+	const bee_sprite_t* sprite = &command->sprite;
+	int32_t umax = sprite->w << 16;
+	int32_t vmax = sprite->h << 16;
+	int skip = clip->left - command->left;
+	for (int y = clip->bottom; y < clip->top; ++y) {
+		float px = command->left + 0.5 - command->tx;
+		float py = y + 0.5 - command->ty;
+		int32_t u = soft_fixed((command->d * px - command->b * py) / command->det) + command->du * skip;
+		int32_t v = soft_fixed((command->a * py - command->c * px) / command->det) + command->dv * skip;
+		uint16_t* dst = g_target->data + y * g_target->width;
+		for (int x = clip->left; x < clip->right; ++x, u += command->du, v += command->dv) {
+			if (u >= 0 && u < umax && v >= 0 && v < vmax) {
+				dst[x] = texture->data[(sprite->y + (v >> 16)) * texture->width + sprite->x + (u >> 16)];
+			}
+		}
+	}
+}
+
+static void soft_clear(const rect_t* clip) {
+	for (int y = clip->bottom; y < clip->top; ++y) {
+		memset(g_target->data + y * g_target->width + clip->left, 0, (clip->right - clip->left) * sizeof(uint16_t));
+	}
+}
+
+static int soft_tiles_x() {
+	return (g_target->width + TILE_SIZE - 1) / TILE_SIZE;
+}
+
+static void soft_tile(int index) {
+	int tiles_x = soft_tiles_x();
+	rect_t tile;
+	tile.left = index % tiles_x * TILE_SIZE;
+	tile.bottom = index / tiles_x * TILE_SIZE;
+	tile.right = tile.left + TILE_SIZE < g_target->width ? tile.left + TILE_SIZE : g_target->width;
+	tile.top = tile.bottom + TILE_SIZE < g_target->height ? tile.bottom + TILE_SIZE : g_target->height;
+
+	// every tile draws its commands in the order they were queued
+	for (int i = g_bin_starts[index]; i < g_bin_starts[index + 1]; ++i) {
+		const command_t* command = g_commands + g_bins[i];
+		rect_t clip = command->bounds;
+		clip.left = clip.left > tile.left ? clip.left : tile.left;
+		clip.bottom = clip.bottom > tile.bottom ? clip.bottom : tile.bottom;
+		clip.right = clip.right < tile.right ? clip.right : tile.right;
+		clip.top = clip.top < tile.top ? clip.top : tile.top;
+		switch (command->type) {
+		case COMMAND_CLEAR:
+			soft_clear(&clip);
+			break;
+		case COMMAND_ALIGNED:
+			soft_draw_aligned(command, &clip);
+			break;
+		case COMMAND_AFFINE:
+			soft_draw_affine(command, &clip);
+			break;
+		}
+	}
+}
+
+// bins the queued commands into tiles in submission order then rasterises the tiles
+static void soft_flush() {
+	if (g_command_count == 0) {
+		return;
+	}
+	long long begin = bee__profile_begin();
+
+	int tiles_x = soft_tiles_x();
+	int tiles = tiles_x * ((g_target->height + TILE_SIZE - 1) / TILE_SIZE);
+	mint_array_check(g_bin_starts, tiles + 1);
+	memset(g_bin_starts, 0, (tiles + 1) * sizeof(int));
+	for (int i = 0; i < g_command_count; ++i) {
+		const rect_t* bounds = &g_commands[i].bounds;
+		for (int y = bounds->bottom / TILE_SIZE; y <= (bounds->top - 1) / TILE_SIZE; ++y) {
+			for (int x = bounds->left / TILE_SIZE; x <= (bounds->right - 1) / TILE_SIZE; ++x) {
+				++g_bin_starts[y * tiles_x + x + 1];
+			}
+		}
+	}
+	for (int i = 0; i < tiles; ++i) {
+		g_bin_starts[i + 1] += g_bin_starts[i];
+	}
+
+	if (g_bin_capacity < g_bin_starts[tiles]) {
+		g_bin_capacity = g_bin_starts[tiles];
+		mint_array_check(g_bins, g_bin_capacity);
+	}
+	for (int i = 0; i < g_command_count; ++i) {
+		const rect_t* bounds = &g_commands[i].bounds;
+		for (int y = bounds->bottom / TILE_SIZE; y <= (bounds->top - 1) / TILE_SIZE; ++y) {
+			for (int x = bounds->left / TILE_SIZE; x <= (bounds->right - 1) / TILE_SIZE; ++x) {
+				g_bins[g_bin_starts[y * tiles_x + x]++] = i;
+			}
+		}
+	}
+	// filling moved every start along to the next tile's
+	for (int i = tiles; i > 0; --i) {
+		g_bin_starts[i] = g_bin_starts[i - 1];
+	}
+	g_bin_starts[0] = 0;
+
+	soft_parallel(soft_tile, tiles);
+	g_command_count = 0;
+	bee__profile_count(BEE__PROFILE_FLUSHES, 1);
+	bee__profile_end(BEE__PROFILE_FLUSH, begin);
+}
+
+static command_t* soft_queue(command_type_t type, int left, int bottom, int right, int top) {
+	if (left < 0) {
+		left = 0;
+	}
+	if (right > g_target->width) {
+		right = g_target->width;
+	}
+	if (bottom < 0) {
+		bottom = 0;
+	}
+	if (top > g_target->height) {
+		top = g_target->height;
+	}
+	if (left >= right || bottom >= top) {
+		return NULL;
+	}
+
+	mint_array_check(g_commands, g_command_count + 1);
+	command_t* command = g_commands + g_command_count++;
+	command->type = type;
+	command->bounds.left = left;
+	command->bounds.bottom = bottom;
+	command->bounds.right = right;
+	command->bounds.top = top;
+	return command;
+}
+
+static void soft_queue_aligned(texture_t* texture, const bee_sprite_t* sprite,
+		int32_t a, int32_t d, int32_t tx, int32_t ty) {
+	int64_t x0 = tx;
+	int64_t x1 = tx + (int64_t)a * sprite->w;
+	int64_t y0 = ty;
+	int64_t y1 = ty + (int64_t)d * sprite->h;
+	if (x0 > x1) {
+		int64_t swap = x0;
+		x0 = x1;
+		x1 = swap;
+	}
+	if (y0 > y1) {
+		int64_t swap = y0;
+		y0 = y1;
+		y1 = swap;
+	}
+
+	// pixels whose centres fall inside the sprite, stepped from the unclipped corner
+	int left0 = soft_snap(x0);
+	int bottom0 = soft_snap(y0);
+	int left = left0;
+	int right = soft_snap(x1);
+	int32_t du = soft_div(FIXED_ONE, a);
+	int32_t u0 = soft_div((int64_t)left0 * FIXED_ONE + FIXED_ONE / 2 - tx, a);
+	int32_t umax = sprite->w << 16;
+	while (left < right && (u0 + du * (left - left0) < 0 || u0 + du * (left - left0) >= umax)) {
+		++left;
+	}
+	while (right > left && (u0 + du * (right - 1 - left0) < 0 || u0 + du * (right - 1 - left0) >= umax)) {
+		--right;
+	}
+
+	command_t* command = soft_queue(COMMAND_ALIGNED, left, bottom0, right, soft_snap(y1));
+	if (command != NULL) {
+		command->texture = texture;
+		command->sprite = *sprite;
+		command->left = left0;
+		command->bottom = bottom0;
+		command->u = u0;
+		command->du = du;
+		command->v = soft_div((int64_t)bottom0 * FIXED_ONE + FIXED_ONE / 2 - ty, d);
+		command->dv = soft_div(FIXED_ONE, d);
+	}
+}
+
+static void soft_queue_affine(texture_t* texture, const bee_sprite_t* sprite,
+		float a, float b, float c, float d, float tx, float ty) {
+	float det = a * d - b * c;
+	if (det == 0) {
+		return;
+	}
+
+	// bounding box of the transformed corners
+	float x0 = tx, x1 = tx, y0 = ty, y1 = ty;
+	for (int i = 1; i < 4; ++i) {
+		float u = (i & 1) ? sprite->w : 0;
+		float v = (i & 2) ? sprite->h : 0;
+		float x = a * u + b * v + tx;
+		float y = c * u + d * v + ty;
+		x0 = fminf(x0, x);
+		x1 = fmaxf(x1, x);
+		y0 = fminf(y0, y);
+		y1 = fmaxf(y1, y);
+	}
+
+	int left0 = ceilf(x0 - 0.5);
+	command_t* command = soft_queue(COMMAND_AFFINE, left0, ceilf(y0 - 0.5), ceilf(x1 - 0.5), ceilf(y1 - 0.5));
+	if (command != NULL) {
+		command->texture = texture;
+		command->sprite = *sprite;
+		command->left = left0;
+		command->du = soft_fixed(d / det);
+		command->dv = soft_fixed(-c / det);
+		command->a = a;
+		command->b = b;
+		command->c = c;
+		command->d = d;
+		command->tx = tx;
+		command->ty = ty;
+		command->det = det;
+	}
+}
+
+// converts RGBA4444 to 0x00RRGGBB and repeats every pixel scale times
+static void present_span(uint32_t* dst, const uint16_t* src, int count, int scale) {
+	int i = 0;
+#ifdef __SSE2__
+	if (scale == 4 || scale == 2 || scale == 1) {
+		const __m128i mask = _mm_set1_epi16(0xF);
+		for (; i + 8 <= count; i += 8) {
+			__m128i pixel = _mm_loadu_si128((const __m128i*)(src + i));
+			__m128i r = _mm_and_si128(_mm_srli_epi16(pixel, 12), mask);
+			__m128i g = _mm_and_si128(_mm_srli_epi16(pixel, 8), mask);
+			__m128i b = _mm_and_si128(_mm_srli_epi16(pixel, 4), mask);
+			r = _mm_or_si128(r, _mm_slli_epi16(r, 4));
+			__m128i gb = _mm_or_si128(_mm_slli_epi16(_mm_or_si128(g, _mm_slli_epi16(g, 4)), 8),
+					_mm_or_si128(b, _mm_slli_epi16(b, 4)));
+			__m128i lo = _mm_unpacklo_epi16(gb, r);
+			__m128i hi = _mm_unpackhi_epi16(gb, r);
+
+			__m128i* out = (__m128i*)(dst + i * scale);
+			if (scale == 4) {
+				_mm_storeu_si128(out + 0, _mm_shuffle_epi32(lo, _MM_SHUFFLE(0, 0, 0, 0)));
+				_mm_storeu_si128(out + 1, _mm_shuffle_epi32(lo, _MM_SHUFFLE(1, 1, 1, 1)));
+				_mm_storeu_si128(out + 2, _mm_shuffle_epi32(lo, _MM_SHUFFLE(2, 2, 2, 2)));
+				_mm_storeu_si128(out + 3, _mm_shuffle_epi32(lo, _MM_SHUFFLE(3, 3, 3, 3)));
+				_mm_storeu_si128(out + 4, _mm_shuffle_epi32(hi, _MM_SHUFFLE(0, 0, 0, 0)));
+				_mm_storeu_si128(out + 5, _mm_shuffle_epi32(hi, _MM_SHUFFLE(1, 1, 1, 1)));
+				_mm_storeu_si128(out + 6, _mm_shuffle_epi32(hi, _MM_SHUFFLE(2, 2, 2, 2)));
+				_mm_storeu_si128(out + 7, _mm_shuffle_epi32(hi, _MM_SHUFFLE(3, 3, 3, 3)));
+			} else if (scale == 2) {
+				_mm_storeu_si128(out + 0, _mm_unpacklo_epi32(lo, lo));
+				_mm_storeu_si128(out + 1, _mm_unpackhi_epi32(lo, lo));
+				_mm_storeu_si128(out + 2, _mm_unpacklo_epi32(hi, hi));
+				_mm_storeu_si128(out + 3, _mm_unpackhi_epi32(hi, hi));
+			} else {
+				_mm_storeu_si128(out + 0, lo);
+				_mm_storeu_si128(out + 1, hi);
+			}
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		uint16_t pixel = src[i];
+		uint32_t value = ((pixel >> 12) & 0xF) * 0x110000
+				| ((pixel >> 8) & 0xF) * 0x1100
+				| ((pixel >> 4) & 0xF) * 0x11;
+		for (int j = 0; j < scale; ++j) {
+			dst[i * scale + j] = value;
+		}
+	}
+}
+
+static void soft_present(int index) {
+	const texture_t* src = g_present_source;
+	int scale = g_present_scale;
+	int width = src->width * scale;
+	int end = (index + 1) * PRESENT_ROWS < src->height ? (index + 1) * PRESENT_ROWS : src->height;
+	for (int y = index * PRESENT_ROWS; y < end; ++y) {
+		uint32_t* dst = g_present + y * scale * width;
+		present_span(dst, src->data + y * src->width, src->width, scale);
+		for (int i = 1; i < scale; ++i) {
+			memcpy(dst + i * width, dst, width * sizeof(uint32_t));
+		}
+	}
+}
+
+void bee__video_init_native(void* window) {
+	g_screen.width = BEE__WINDOW_SIZE;
+	g_screen.height = BEE__WINDOW_SIZE;
+	g_screen.data = calloc(BEE__WINDOW_SIZE * BEE__WINDOW_SIZE, sizeof(uint16_t));
+	mint_create(g_screen.data, buffer_destroy);
+	g_present = malloc(BEE__WINDOW_SIZE * BEE__WINDOW_SIZE * sizeof(uint32_t));
+	mint_create(g_present, buffer_destroy);
+	g_target = &g_screen;
+
+	// this thread does its share so it only needs a worker for each other core
+	int threads = bee__thread_cores();
+	const char* option = bee__option_get("threads");
+	if (option != NULL) {
+		threads = atoi(option);
+		if (threads <= 0) {
+			mint_fail("SOFT: Invalid threads '%s'", option);
+		}
+	}
+	g_worker_count = threads - 1 < WORKER_MAX ? threads - 1 : WORKER_MAX;
+	for (int i = 0; i < g_worker_count; ++i) {
+		g_workers[i].start = bee__signal_create();
+		g_workers[i].done = bee__signal_create();
+		g_workers[i].thread = bee__thread_create(worker_main, g_workers + i);
+	}
+	mint_create(g_workers, worker_destroy);
+	mint_info("SOFT: Software renderer, %i threads", g_worker_count + 1);
+}
+
+void bee__video_present_native(void* texture) {
+	soft_flush();
+	g_present_source = texture;
+	g_present_scale = BEE__WINDOW_SIZE / g_present_source->width;
+	soft_parallel(soft_present, (g_present_source->height + PRESENT_ROWS - 1) / PRESENT_ROWS);
+	bee__window_present(g_present_source->width * g_present_scale,
+			g_present_source->height * g_present_scale, g_present);
+}
+
+void bee__video_clear_native() {
+	soft_queue(COMMAND_CLEAR, 0, 0, g_target->width, g_target->height);
+}
+
+void* bee__video_texture_create_native(int width, int height, unsigned short* data) {
+	texture_t* texture = malloc(sizeof(texture_t));
+	texture->width = width;
+	texture->height = height;
+	texture->data = calloc(width * height, sizeof(uint16_t));
+	texture->indices = NULL;
+	texture->palette = 0;
+	if (data != NULL) {
+		memcpy(texture->data, data, width * height * sizeof(uint16_t));
+	}
+	mint_create(texture, texture_destroy);
+	return texture;
+}
+
+void bee__video_texture_update_native(void* texture, const bee_sprite_t* sprite, unsigned short* data) {
+	soft_flush();
+	texture_t* dst = texture;
+	for (int y = 0; y < sprite->h; ++y) {
+		memcpy(dst->data + (sprite->y + y) * dst->width + sprite->x, data + y * sprite->w, sprite->w * sizeof(uint16_t));
+	}
+}
+
+unsigned short* bee__video_texture_map_native(void* texture) {
+	// queued draws may still read from or write to the texture
+	soft_flush();
+	return ((texture_t*)texture)->data;
+}
+
+void bee__video_texture_unmap_native(void* texture) {
+}
+
+void bee__video_texture_read(void* texture, const bee_sprite_t* sprite, unsigned short* data) {
+	soft_flush();
+	texture_t* src = texture;
+	for (int y = 0; y < sprite->h; ++y) {
+		memcpy(data + y * sprite->w, src->data + (sprite->y + y) * src->width + sprite->x, sprite->w * sizeof(uint16_t));
+	}
+}
+
+void* bee__video_index_create_native(int width, int height) {
+	texture_t* texture = malloc(sizeof(texture_t));
+	texture->width = width;
+	texture->height = height;
+	texture->data = calloc(width * height, sizeof(uint16_t));
+	texture->indices = calloc(width * height, sizeof(uint8_t));
+	texture->palette = 0;
+	mint_create(texture, texture_destroy);
+	return texture;
+}
+
+void bee__video_index_update_native(void* texture, const bee_sprite_t* sprite, unsigned char* data) {
+	soft_flush();
+	texture_t* dst = texture;
+	for (int y = 0; y < sprite->h; ++y) {
+		memcpy(dst->indices + (sprite->y + y) * dst->width + sprite->x, data + y * sprite->w, sprite->w);
+	}
+	dst->palette = 0;
+}
+
+unsigned char* bee__video_index_map_native(void* texture) {
+	soft_flush();
+	return ((texture_t*)texture)->indices;
+}
+
+void bee__video_index_unmap_native(void* texture) {
+	((texture_t*)texture)->palette = 0;
+}
+
+void bee__video_palette_native(int index, int count, const unsigned short* colors) {
+	// queued draws still look up the old colours
+	soft_flush();
+	memcpy(g_palette + index, colors, count * sizeof(uint16_t));
+	++g_palette_version;
+}
+
+void bee__video_texture_target_native(void* texture) {
+	soft_flush();
+	long long begin = bee__profile_begin();
+	if (texture == NULL) {
+		g_target = &g_screen;
+	} else {
+		g_target = texture;
+	}
+	bee__profile_count(BEE__PROFILE_TARGETS, 1);
+	bee__profile_end(BEE__PROFILE_TARGET, begin);
+}
+
+void bee__video_texture_draw_native(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix) {
+	texture_t* src = texture;
+	if (sprite->w <= 0 || sprite->h <= 0 || sprite->x < 0 || sprite->y < 0
+			|| sprite->x + sprite->w > src->width || sprite->y + sprite->h > src->height) {
+		return;
+	}
+
+	// maps sprite texels onto target pixels in 16.16, the canvas is 128 pixels across
+	int64_t sx = g_target->width;
+	int64_t sy = g_target->height;
+	int32_t a = matrix->m00 * sx / 128;
+	int32_t b = matrix->m01 * sx / 128;
+	int32_t c = matrix->m10 * sy / 128;
+	int32_t d = matrix->m11 * sy / 128;
+	int32_t tx = (matrix->m02 * sx + FIXED_ONE * 64 * sx) / 128 - ((int64_t)a * sprite->w + (int64_t)b * sprite->h) / 2;
+	int32_t ty = (matrix->m12 * sy + FIXED_ONE * 64 * sy) / 128 - ((int64_t)c * sprite->w + (int64_t)d * sprite->h) / 2;
+
+	// queued draws have already been flushed if the palette or indices changed since the last look up
+	if (src->indices != NULL && src->palette != g_palette_version) {
+		for (int i = 0; i < src->width * src->height; ++i) {
+			src->data[i] = g_palette[src->indices[i]];
+		}
+		src->palette = g_palette_version;
+	}
+
+	bee__profile_count(BEE__PROFILE_DRAWS, 1);
+	if (bee__matrix_aligned(matrix)) {
+		if (a != 0 && d != 0) {
+			soft_queue_aligned(src, sprite, a, d, tx, ty);
+		}
+	} else {
+		soft_queue_affine(src, sprite, (float)a / FIXED_ONE, (float)b / FIXED_ONE, (float)c / FIXED_ONE,
+				(float)d / FIXED_ONE, (float)tx / FIXED_ONE, (float)ty / FIXED_ONE);
+	}
+}
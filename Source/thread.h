@@ -0,0 +1,40 @@
+/*
+ * thread.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef THREAD_H_
+#define THREAD_H_
+
+#include <8bee.h>
+
+void* bee__thread_create(bee_callback_t func, void* data);
+void bee__thread_join(void* thread);
+// how many threads can run at once
+int bee__thread_cores();
+
+void* bee__mutex_create();
+void bee__mutex_lock(void* mutex);
+void bee__mutex_unlock(void* mutex);
+void bee__mutex_destroy(void* mutex);
+
+// wakes one waiting thread, or the next one to wait if none are waiting
+void* bee__signal_create();
+void bee__signal_post(void* signal);
+void bee__signal_wait(void* signal);
+void bee__signal_destroy(void* signal);
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * trace.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace.h"
+#include "option.h"
+#include <mint.h>
+#include <stdio.h>
+
+typedef struct texture_t {
+	void* texture;
+	int width;
+	int height;
+} texture_t;
+
+static FILE* g_file;
+static texture_t* g_textures;
+static int g_texture_count = 0;
+
+static void trace_destroy(void* data) {
+	fclose(data);
+}
+
+static void trace_u8(int value) {
+	fputc(value, g_file);
+}
+
+static void trace_u16(int value) {
+	fputc(value & 0xFF, g_file);
+	fputc((value >> 8) & 0xFF, g_file);
+}
+
+static void trace_i32(int value) {
+	trace_u16(value & 0xFFFF);
+	trace_u16((value >> 16) & 0xFFFF);
+}
+
+static int trace_find(void* texture) {
+	for (int i = 0; i < g_texture_count; ++i) {
+		if (g_textures[i].texture == texture) {
+			return i;
+		}
+	}
+	mint_fail("TRACE: Unknown texture");
+}
+
+static void trace_texture(void* texture) {
+	trace_u16(trace_find(texture));
+}
+
+static void trace_sprite(const bee_sprite_t* sprite) {
+	trace_u16(sprite->x);
+	trace_u16(sprite->y);
+	trace_u16(sprite->w);
+	trace_u16(sprite->h);
+}
+
+void bee__trace_init() {
+	const char* path = bee__option_get("trace");
+	if (path != NULL) {
+		g_file = fopen(path, "wb");
+		if (g_file == NULL) {
+			mint_fail("TRACE: Failed to open '%s'", path);
+		}
+		mint_create(g_file, trace_destroy);
+		fwrite(BEE__TRACE_MAGIC, 1, 4, g_file);
+		mint_info("TRACE: Capturing to '%s'", path);
+	}
+}
+
+static void trace_create(bee__trace_op_t op, void* texture, int width, int height) {
+	if (g_file != NULL) {
+		mint_array_check(g_textures, g_texture_count + 1);
+		texture_t* entry = g_textures + g_texture_count++;
+		entry->texture = texture;
+		entry->width = width;
+		entry->height = height;
+		trace_u8(op);
+		trace_u16(width);
+		trace_u16(height);
+	}
+}
+
+void bee__trace_create(void* texture, int width, int height) {
+	trace_create(BEE__TRACE_CREATE, texture, width, height);
+}
+
+void bee__trace_update(void* texture, const bee_sprite_t* sprite, const unsigned short* data) {
+	if (g_file != NULL) {
+		trace_u8(BEE__TRACE_UPDATE);
+		trace_texture(texture);
+		trace_sprite(sprite);
+		for (int i = 0; i < sprite->w * sprite->h; ++i) {
+			trace_u16(data[i]);
+		}
+	}
+}
+
+void bee__trace_unmap(void* texture, const unsigned short* data) {
+	if (g_file != NULL) {
+		texture_t* entry = g_textures + trace_find(texture);
+		bee_sprite_t all = {0, 0, entry->width, entry->height};
+		bee__trace_update(texture, &all, data);
+	}
+}
+
+void bee__trace_create_indexed(void* texture, int width, int height) {
+	trace_create(BEE__TRACE_CREATE_INDEXED, texture, width, height);
+}
+
+void bee__trace_update_indexed(void* texture, const bee_sprite_t* sprite, const unsigned char* data) {
+	if (g_file != NULL) {
+		trace_u8(BEE__TRACE_UPDATE_INDEXED);
+		trace_texture(texture);
+		trace_sprite(sprite);
+		fwrite(data, 1, sprite->w * sprite->h, g_file);
+	}
+}
+
+void bee__trace_unmap_indexed(void* texture, const unsigned char* data) {
+	if (g_file != NULL) {
+		texture_t* entry = g_textures + trace_find(texture);
+		bee_sprite_t all = {0, 0, entry->width, entry->height};
+		bee__trace_update_indexed(texture, &all, data);
+	}
+}
+
+void bee__trace_palette(int index, int count, const unsigned short* colors) {
+	if (g_file != NULL) {
+		trace_u8(BEE__TRACE_PALETTE);
+		trace_u16(index);
+		trace_u16(count);
+		for (int i = 0; i < count; ++i) {
+			trace_u16(colors[i]);
+		}
+	}
+}
+
+void bee__trace_target(void* texture) {
+	if (g_file != NULL) {
+		trace_u8(BEE__TRACE_TARGET);
+		if (texture == NULL) {
+			trace_u16(BEE__TRACE_SCREEN);
+		} else {
+			trace_texture(texture);
+		}
+	}
+}
+
+void bee__trace_clear() {
+	if (g_file != NULL) {
+		trace_u8(BEE__TRACE_CLEAR);
+	}
+}
+
+void bee__trace_draw(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix) {
+	if (g_file != NULL) {
+		_Bool aligned = bee__matrix_aligned(matrix);
+		trace_u8(aligned ? BEE__TRACE_DRAW_ALIGNED : BEE__TRACE_DRAW);
+		trace_texture(texture);
+		trace_sprite(sprite);
+		trace_i32(matrix->m00);
+		if (!aligned) {
+			trace_i32(matrix->m01);
+		}
+		trace_i32(matrix->m02);
+		if (!aligned) {
+			trace_i32(matrix->m10);
+		}
+		trace_i32(matrix->m11);
+		trace_i32(matrix->m12);
+	}
+}
+
+void bee__trace_present(void* texture) {
+	if (g_file != NULL) {
+		trace_u8(BEE__TRACE_PRESENT);
+		trace_texture(texture);
+	}
+}
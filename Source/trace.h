@@ -0,0 +1,65 @@
+/*
+ * trace.h
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+#include <8bee.h>
+#include "transform.h"
+
+// traces are the magic followed by a stream of commands, all little-endian
+#define BEE__TRACE_MAGIC "BEET"
+
+typedef enum bee__trace_op_t {
+	// u16 width, u16 height, creates the next texture id
+	BEE__TRACE_CREATE,
+	// u16 texture, u16 x, y, w, h, then w * h u16 pixels
+	BEE__TRACE_UPDATE,
+	// u16 texture, BEE__TRACE_SCREEN for the screen
+	BEE__TRACE_TARGET,
+	BEE__TRACE_CLEAR,
+	// u16 texture, u16 x, y, w, h, then i32 m00, m01, m02, m10, m11, m12
+	BEE__TRACE_DRAW,
+	// as above without m01 and m10 which are zero
+	BEE__TRACE_DRAW_ALIGNED,
+	// u16 texture shown on the window
+	BEE__TRACE_PRESENT,
+	// u16 width, u16 height, creates the next texture id as an indexed texture
+	BEE__TRACE_CREATE_INDEXED,
+	// u16 texture, u16 x, y, w, h, then w * h u8 indices
+	BEE__TRACE_UPDATE_INDEXED,
+	// u16 index, u16 count, then count u16 colours
+	BEE__TRACE_PALETTE
+} bee__trace_op_t;
+
+#define BEE__TRACE_SCREEN 0xFFFF
+
+void bee__trace_init();
+void bee__trace_create(void* texture, int width, int height);
+void bee__trace_update(void* texture, const bee_sprite_t* sprite, const unsigned short* data);
+// traces an update of the whole texture from the data it was mapped to
+void bee__trace_unmap(void* texture, const unsigned short* data);
+void bee__trace_create_indexed(void* texture, int width, int height);
+void bee__trace_update_indexed(void* texture, const bee_sprite_t* sprite, const unsigned char* data);
+void bee__trace_unmap_indexed(void* texture, const unsigned char* data);
+void bee__trace_palette(int index, int count, const unsigned short* colors);
+void bee__trace_target(void* texture);
+void bee__trace_clear();
+void bee__trace_draw(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix);
+void bee__trace_present(void* texture);
+
+#endif
@@ -20,12 +20,24 @@
 #include <8bee.h>
 #include <mint.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 
 static bee__matrix_t* g_stack;
 static int g_stack_index = 0;
 
+// sine of every whole degree, with the quarter turns exact
+static int32_t g_sine[360];
+
+static int32_t transform_mul(int32_t a, int32_t b) {
+	return ((int64_t)a * b + 0x8000) >> 16;
+}
+
 void bee__transform_init() {
+	static const double deg2rad = 0.017453292519943295;
+	for (int i = 0; i < 360; ++i) {
+		g_sine[i] = lrint(sin(i * deg2rad) * BEE__MATRIX_ONE);
+	}
 	mint_array_check(g_stack, 1);
 	bee_identity();
 }
@@ -45,18 +57,18 @@ void bee_pop() {
 
 void bee_identity() {
 	bee__matrix_t* matrix = bee__transform_get();
-	matrix->m00 = 1 / 64.0;
+	matrix->m00 = BEE__MATRIX_ONE;
 	matrix->m01 = 0;
 	matrix->m02 = 0;
 	matrix->m10 = 0;
-	matrix->m11 = 1 / 64.0;
+	matrix->m11 = BEE__MATRIX_ONE;
 	matrix->m12 = 0;
 }
 
 void bee_translate(int x, int y) {
 	bee__matrix_t* matrix = bee__transform_get();
-	matrix->m02 += x;
-	matrix->m12 += y;
+	matrix->m02 += x * BEE__MATRIX_ONE;
+	matrix->m12 += y * BEE__MATRIX_ONE;
 }
 
 void bee_scale(int w, int h) {
@@ -69,17 +81,31 @@ void bee_scale(int w, int h) {
 	matrix->m12 *= h;
 }
 
-void bee_angle(int angle) {
-	static float deg2rad = 0.01745329;
-	float rad = angle * deg2rad;
-	float c = cos(rad);
-	float s = sin(rad);
+void bee_rotate(int angle) {
+	angle %= 360;
+	if (angle < 0) {
+		angle += 360;
+	}
+	if (angle == 0) {
+		return;
+	}
+	int32_t s = g_sine[angle];
+	int32_t c = g_sine[(angle + 90) % 360];
 
 	bee__matrix_t* matrix = bee__transform_get();
-	matrix->m00 = matrix->m00*c - matrix->m10*s;
-	matrix->m01 = matrix->m01*c - matrix->m11*s;
-	matrix->m02 = matrix->m02*c - matrix->m12*s;
-	matrix->m10 = matrix->m00*s + matrix->m10*c;
-	matrix->m11 = matrix->m01*s + matrix->m11*c;
-	matrix->m12 = matrix->m02*s + matrix->m12*c;
+	bee__matrix_t r = *matrix;
+	if (bee__matrix_aligned(&r)) {
+		// only the diagonal and translation are set so half the products are zero
+		matrix->m00 = transform_mul(r.m00, c);
+		matrix->m01 = -transform_mul(r.m11, s);
+		matrix->m10 = transform_mul(r.m00, s);
+		matrix->m11 = transform_mul(r.m11, c);
+	} else {
+		matrix->m00 = transform_mul(r.m00, c) - transform_mul(r.m10, s);
+		matrix->m01 = transform_mul(r.m01, c) - transform_mul(r.m11, s);
+		matrix->m10 = transform_mul(r.m00, s) + transform_mul(r.m10, c);
+		matrix->m11 = transform_mul(r.m01, s) + transform_mul(r.m11, c);
+	}
+	matrix->m02 = transform_mul(r.m02, c) - transform_mul(r.m12, s);
+	matrix->m12 = transform_mul(r.m02, s) + transform_mul(r.m12, c);
 }
@@ -19,12 +19,19 @@
 #ifndef TRANSFORM_H_
 #define TRANSFORM_H_
 
+// matrices are 16.16 fixed point with the translation in canvas pixels from the centre
+#define BEE__MATRIX_ONE 0x10000
+
 typedef struct bee__matrix_t {
-	float m00, m01, m02;
-	float m10, m11, m12;
+	int m00, m01, m02;
+	int m10, m11, m12;
 } bee__matrix_t;
 
 void bee__transform_init();
 bee__matrix_t* bee__transform_get();
 
+static inline _Bool bee__matrix_aligned(const bee__matrix_t* matrix) {
+	return matrix->m01 == 0 && matrix->m10 == 0;
+}
+
 #endif
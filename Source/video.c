@@ -18,36 +18,125 @@
 
 #include "video.h"
 #include "window.h"
+#include "atlas.h"
+#include "option.h"
+#include "profile.h"
+#include "trace.h"
+#include "arena.h"
 #include <stddef.h>
 
 static const bee_sprite_t g_all = {0, 0, 128, 128};
 static void* g_buffer;
-static void* g_texdata;
+static bee_callback_t g_readback;
+static unsigned short g_readback_data[128 * 128];
+static _Bool g_redraw;
+static _Bool g_lazy;
+static void* g_mapped;
 
 void bee__video_init() {
+	g_redraw = bee__option_get("redraw") != NULL;
+	g_lazy = bee__option_get("lazy") != NULL;
 	bee__video_init_native(bee__window_get());
 	g_buffer = bee__video_texture_create(128, 128, NULL);
-	g_texdata = bee__video_texture_create(128, 128, NULL);
 	bee__video_texture_target(g_buffer);
 }
 
-void bee__video_data(unsigned short* data) {
-	bee__video_texture_update(g_texdata, &g_all, data);
+void bee__video_readback(bee_callback_t callback) {
+	g_readback = callback;
 }
 
 void bee__video_update() {
-	static const bee__matrix_t identity = {
-			1 / 64.0, 0,        0,
-			0,        1 / 64.0, 0
-	};
+	// the buffer is kept between frames so unchanged frames can skip drawing it
+	_Bool changed = g_redraw || bee__atlas_changed();
+	if (changed) {
+		bee__video_clear();
+		bee__atlas_flush();
+	} else {
+		bee__atlas_discard();
+		bee__profile_count(BEE__PROFILE_SKIPS, 1);
+	}
 
-	bee__video_texture_target(NULL);
-	bee__video_texture_draw(g_buffer, &g_all, &identity);
-	bee__video_texture_target(g_buffer);
-	bee__video_clear();
-	bee__video_update_native();
+	if (g_readback != NULL) {
+		bee__video_texture_read(g_buffer, &g_all, g_readback_data);
+		g_readback(g_readback_data);
+	}
+
+	if (changed || !g_lazy) {
+		bee__video_present(g_buffer);
+	}
+	bee__arena_reset();
+}
+
+void bee__video_present(void* texture) {
+	bee__trace_present(texture);
+	bee__video_present_native(texture);
+}
+
+void bee__video_clear() {
+	bee__trace_clear();
+	bee__video_clear_native();
+}
+
+void* bee__video_texture_create(int width, int height, unsigned short* data) {
+	void* texture = bee__video_texture_create_native(width, height, data);
+	bee__trace_create(texture, width, height);
+	if (data != NULL) {
+		bee_sprite_t all = {0, 0, width, height};
+		bee__trace_update(texture, &all, data);
+	}
+	return texture;
+}
+
+void bee__video_texture_update(void* texture, const bee_sprite_t* sprite, unsigned short* data) {
+	bee__trace_update(texture, sprite, data);
+	bee__video_texture_update_native(texture, sprite, data);
+}
+
+void bee__video_texture_target(void* texture) {
+	bee__trace_target(texture);
+	bee__video_texture_target_native(texture);
+}
+
+void bee__video_texture_draw(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix) {
+	bee__trace_draw(texture, sprite, matrix);
+	bee__video_texture_draw_native(texture, sprite, matrix);
+}
+
+unsigned short* bee__video_texture_map(void* texture) {
+	unsigned short* data = bee__video_texture_map_native(texture);
+	g_mapped = data;
+	return data;
+}
+
+void bee__video_texture_unmap(void* texture) {
+	// the whole texture is traced with what was written through the mapping
+	bee__trace_unmap(texture, g_mapped);
+	bee__video_texture_unmap_native(texture);
+}
+
+void* bee__video_index_create(int width, int height) {
+	void* texture = bee__video_index_create_native(width, height);
+	bee__trace_create_indexed(texture, width, height);
+	return texture;
+}
+
+void bee__video_index_update(void* texture, const bee_sprite_t* sprite, unsigned char* data) {
+	bee__trace_update_indexed(texture, sprite, data);
+	bee__video_index_update_native(texture, sprite, data);
+}
+
+unsigned char* bee__video_index_map(void* texture) {
+	unsigned char* data = bee__video_index_map_native(texture);
+	g_mapped = data;
+	return data;
+}
+
+void bee__video_index_unmap(void* texture) {
+	bee__trace_unmap_indexed(texture, g_mapped);
+	bee__video_index_unmap_native(texture);
 }
 
-void bee_draw(const bee_sprite_t* sprite) {
-	bee__video_texture_draw(g_texdata, sprite, bee__transform_get());
+void bee__video_palette(int index, int count, const unsigned short* colors) {
+	bee__trace_palette(index, count, colors);
+	bee__video_palette_native(index, count, colors);
 }
@@ -21,17 +21,49 @@
 #include <8bee.h>
 #include "transform.h"
 
+// implemented by each backend, the game goes through the functions below so traces are captured in one place
 void bee__video_init_native(void* window);
-void bee__video_update_native();
-void bee__video_clear();
+// shows a texture on the window scaled up by a whole factor
+void bee__video_present_native(void* texture);
+void bee__video_clear_native();
+
+void* bee__video_texture_create_native(int width, int height, unsigned short* data);
+void bee__video_texture_update_native(void* texture, const bee_sprite_t* sprite, unsigned short* data);
+void bee__video_texture_target_native(void* texture);
+void bee__video_texture_draw_native(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix);
+unsigned short* bee__video_texture_map_native(void* texture);
+void bee__video_texture_unmap_native(void* texture);
+void bee__video_texture_read(void* texture, const bee_sprite_t* sprite, unsigned short* data);
+
+// indexed textures hold a byte per pixel that is looked up in the palette when drawn,
+// they can be drawn from but not targeted, read or presented
+void* bee__video_index_create_native(int width, int height);
+void bee__video_index_update_native(void* texture, const bee_sprite_t* sprite, unsigned char* data);
+unsigned char* bee__video_index_map_native(void* texture);
+void bee__video_index_unmap_native(void* texture);
+// replaces count of the 256 palette entries starting at index
+void bee__video_palette_native(int index, int count, const unsigned short* colors);
 
+// trace the call when capturing then pass it on to the backend,
+// only one texture may be mapped at a time
+void bee__video_present(void* texture);
+void bee__video_clear();
 void* bee__video_texture_create(int width, int height, unsigned short* data);
 void bee__video_texture_update(void* texture, const bee_sprite_t* sprite, unsigned short* data);
 void bee__video_texture_target(void* texture);
 void bee__video_texture_draw(void* texture, const bee_sprite_t* sprite, const bee__matrix_t* matrix);
+unsigned short* bee__video_texture_map(void* texture);
+void bee__video_texture_unmap(void* texture);
+void* bee__video_index_create(int width, int height);
+void bee__video_index_update(void* texture, const bee_sprite_t* sprite, unsigned char* data);
+unsigned char* bee__video_index_map(void* texture);
+void bee__video_index_unmap(void* texture);
+void bee__video_palette(int index, int count, const unsigned short* colors);
 
 void bee__video_init();
-void bee__video_data(unsigned short* data);
 void bee__video_update();
 
+// called with the 128x128 game buffer before every present
+void bee__video_readback(bee_callback_t callback);
+
 #endif
@@ -0,0 +1,48 @@
+/*
+ * clock.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../clock.h"
+#include <mint.h>
+#include <windows.h>
+
+static long long g_frequency;
+
+static void period_destroy(void* data) {
+	timeEndPeriod(1);
+}
+
+long long bee__clock_get() {
+	if (g_frequency == 0) {
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		g_frequency = frequency.QuadPart;
+
+		// let Sleep wake up with millisecond precision
+		timeBeginPeriod(1);
+		mint_create(&g_frequency, period_destroy);
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart / g_frequency * 1000000000LL
+			+ counter.QuadPart % g_frequency * 1000000000LL / g_frequency;
+}
+
+void bee__clock_sleep(long long duration) {
+	Sleep(duration / 1000000);
+}
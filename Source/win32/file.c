@@ -0,0 +1,87 @@
+/*
+ * file.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../file.h"
+#include <mint.h>
+#include <windows.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+static void file_destroy(void* data) {
+	bee__file_t* file = data;
+	if (file->data != NULL) {
+		UnmapViewOfFile(file->data);
+	}
+	free(file);
+}
+
+bee__file_t* bee__file_map(const char* path) {
+	HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE) {
+		return NULL;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(handle, &size)) {
+		CloseHandle(handle);
+		return NULL;
+	}
+
+	bee__file_t* file = malloc(sizeof(bee__file_t));
+	file->data = NULL;
+	file->length = size.QuadPart;
+	if (file->length > 0) {
+		HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping != NULL) {
+			file->data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+		if (file->data == NULL) {
+			CloseHandle(handle);
+			free(file);
+			return NULL;
+		}
+	}
+	CloseHandle(handle);
+	mint_create(file, file_destroy);
+	return file;
+}
+
+_Bool bee__file_replace(const char* path, const void* data, int length) {
+	char temp[MAX_PATH];
+	if (snprintf(temp, sizeof(temp), "%s.tmp", path) >= (int)sizeof(temp)) {
+		return 0;
+	}
+
+	HANDLE handle = CreateFileA(temp, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE) {
+		return 0;
+	}
+	DWORD size;
+	if (!WriteFile(handle, data, length, &size, NULL) || size != (DWORD)length || !FlushFileBuffers(handle)) {
+		CloseHandle(handle);
+		DeleteFileA(temp);
+		return 0;
+	}
+	CloseHandle(handle);
+	if (!MoveFileExA(temp, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+		DeleteFileA(temp);
+		return 0;
+	}
+	return 1;
+}
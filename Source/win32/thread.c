@@ -0,0 +1,97 @@
+/*
+ * thread.c
+ *
+ * Copyright 2018 Joshua Michael Minter
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "../thread.h"
+#include <mint.h>
+#include <stdlib.h>
+#include <windows.h>
+
+typedef struct thread_t {
+	HANDLE handle;
+	bee_callback_t func;
+	void* data;
+} thread_t;
+
+static DWORD WINAPI thread_main(LPVOID data) {
+	thread_t* thread = data;
+	thread->func(thread->data);
+	return 0;
+}
+
+void* bee__thread_create(bee_callback_t func, void* data) {
+	thread_t* thread = malloc(sizeof(thread_t));
+	thread->func = func;
+	thread->data = data;
+	thread->handle = CreateThread(NULL, 0, thread_main, thread, 0, NULL);
+	if (thread->handle == NULL) {
+		mint_fail("WIN32: Failed to create thread");
+	}
+	return thread;
+}
+
+void bee__thread_join(void* data) {
+	thread_t* thread = data;
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+	free(thread);
+}
+
+int bee__thread_cores() {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+}
+
+void* bee__mutex_create() {
+	CRITICAL_SECTION* mutex = malloc(sizeof(CRITICAL_SECTION));
+	InitializeCriticalSection(mutex);
+	return mutex;
+}
+
+void bee__mutex_lock(void* mutex) {
+	EnterCriticalSection(mutex);
+}
+
+void bee__mutex_unlock(void* mutex) {
+	LeaveCriticalSection(mutex);
+}
+
+void bee__mutex_destroy(void* mutex) {
+	DeleteCriticalSection(mutex);
+	free(mutex);
+}
+
+void* bee__signal_create() {
+	HANDLE event = CreateEventA(NULL, FALSE, FALSE, NULL);
+	if (event == NULL) {
+		mint_fail("WIN32: Failed to create event");
+	}
+	return event;
+}
+
+void bee__signal_post(void* signal) {
+	SetEvent(signal);
+}
+
+void bee__signal_wait(void* signal) {
+	WaitForSingleObject(signal, INFINITE);
+}
+
+void bee__signal_destroy(void* signal) {
+	CloseHandle(signal);
+}
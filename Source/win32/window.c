@@ -17,6 +17,8 @@
  */
 
 #include "../window.h"
+#include "../input.h"
+#include <8bee.h>
 #include <mint.h>
 #include <windows.h>
 #include <stdlib.h>
@@ -50,6 +52,28 @@ static void window_destroy(void* data) {
 	DestroyWindow((HWND)data);
 }
 
+static int window_button(WPARAM key) {
+	switch (key) {
+	case VK_UP:
+		return BEE_INPUT_UP;
+	case VK_DOWN:
+		return BEE_INPUT_DOWN;
+	case VK_LEFT:
+		return BEE_INPUT_LEFT;
+	case VK_RIGHT:
+		return BEE_INPUT_RIGHT;
+	case 'Z':
+		return BEE_INPUT_A;
+	case 'X':
+		return BEE_INPUT_B;
+	case VK_RETURN:
+		return BEE_INPUT_START;
+	case VK_SHIFT:
+		return BEE_INPUT_SELECT;
+	}
+	return 0;
+}
+
 static LRESULT CALLBACK window_proc(HWND wnd, UINT msg, WPARAM wpm, LPARAM lpm) {
 	static _Bool show_cursor = 1;
 	switch (msg) {
@@ -68,6 +92,20 @@ static LRESULT CALLBACK window_proc(HWND wnd, UINT msg, WPARAM wpm, LPARAM lpm)
 		ShowCursor(TRUE);
 		show_cursor = 1;
 		break;
+	case WM_KEYDOWN:
+		// skip auto-repeat
+		if (!(lpm & 0x40000000) && window_button(wpm) != 0) {
+			bee__input_event(window_button(wpm), 1);
+		}
+		break;
+	case WM_KEYUP:
+		if (window_button(wpm) != 0) {
+			bee__input_event(window_button(wpm), 0);
+		}
+		break;
+	case WM_KILLFOCUS:
+		bee__input_event(0xFF, 0);
+		break;
 	case WM_DESTROY:
 		PostQuitMessage(EXIT_SUCCESS);
 		break;
@@ -91,7 +129,7 @@ void bee__window_init() {
 	*patom = atom;
 	mint_create(patom, class_destroy);
 
-	static const int size = 512;
+	static const int size = BEE__WINDOW_SIZE;
 	static const DWORD style = WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX;
 	RECT rect;
 	rect.left = GetSystemMetrics(SM_CXSCREEN) / 2 - size / 2;
@@ -137,3 +175,16 @@ void* bee__window_get() {
 void bee__window_show() {
 	ShowWindow(g_window, SW_SHOW);
 }
+
+void bee__window_present(int width, int height, const unsigned int* data) {
+	BITMAPINFO info = {{sizeof(BITMAPINFOHEADER)}};
+	info.bmiHeader.biWidth = width;
+	info.bmiHeader.biHeight = height;
+	info.bmiHeader.biPlanes = 1;
+	info.bmiHeader.biBitCount = 32;
+	info.bmiHeader.biCompression = BI_RGB;
+
+	HDC dc = GetDC(g_window);
+	StretchDIBits(dc, 0, 0, BEE__WINDOW_SIZE, BEE__WINDOW_SIZE, 0, 0, width, height, data, &info, DIB_RGB_COLORS, SRCCOPY);
+	ReleaseDC(g_window, dc);
+}
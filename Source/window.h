@@ -19,10 +19,15 @@
 #ifndef WINDOW_H_
 #define WINDOW_H_
 
+#define BEE__WINDOW_SIZE 512
+
 void bee__window_init();
 void bee__window_update();
 void* bee__window_get();
 
 void bee__window_show();
 
+// presents bottom-up 0x00RRGGBB pixels for backends that render on the CPU
+void bee__window_present(int width, int height, const unsigned int* data);
+
 #endif